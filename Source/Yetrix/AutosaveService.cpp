@@ -0,0 +1,95 @@
+#include "AutosaveService.h"
+
+#include "Yetrix.h"
+#include "YetrixSaveGame.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Autosave write ms"), STAT_YetrixAutosaveWriteMs, STATGROUP_Yetrix);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Autosave latency ms"), STAT_YetrixAutosaveLatencyMs, STATGROUP_Yetrix);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Autosaves coalesced"), STAT_YetrixAutosavesCoalesced, STATGROUP_Yetrix);
+
+AutosaveService::AutosaveService(const FString& theSlotName, const int32 theUserIndex) : slotName(theSlotName), userIndex(theUserIndex) {
+}
+
+void AutosaveService::Request(std::vector<uint8_t>&& data) {
+
+	if (hasPending) {
+		++coalesced;
+		INC_DWORD_STAT(STAT_YetrixAutosavesCoalesced);
+	}
+	else {
+		pendingRequestSeconds = FPlatformTime::Seconds();
+	}
+
+	pendingData = std::move(data);
+	hasPending = true;
+
+	if (!inFlight.IsValid())
+		StartWrite();
+}
+
+void AutosaveService::Tick() {
+
+	if (inFlight.IsValid() && inFlight.IsReady())
+		FinishWrite();
+
+	if (hasPending && !inFlight.IsValid())
+		StartWrite();
+}
+
+void AutosaveService::Flush() {
+
+	if (inFlight.IsValid()) {
+		inFlight.Wait();
+		FinishWrite();
+	}
+
+	if (hasPending) {
+		StartWrite();
+		inFlight.Wait();
+		FinishWrite();
+	}
+}
+
+void AutosaveService::StartWrite() {
+
+	// the save game object is serialized here, it must not be touched off the game thread
+	auto* saveGame = Cast<UYetrixSaveGame>(UGameplayStatics::CreateSaveGameObject(UYetrixSaveGame::StaticClass()));
+	saveGame->binaryDump.Append(pendingData.data(), static_cast<int32>(pendingData.size()));
+
+	TArray<uint8> bytes;
+	UGameplayStatics::SaveGameToMemory(saveGame, bytes);
+
+	requestSeconds = pendingRequestSeconds;
+	hasPending = false;
+	pendingData.clear();
+
+	inFlight = Async(EAsyncExecution::ThreadPool, [bytes = MoveTemp(bytes), slot = slotName, user = userIndex]() {
+
+		const double startSeconds = FPlatformTime::Seconds();
+		const bool saved = UGameplayStatics::SaveDataToSlot(bytes, slot, user);
+		return saved ? (FPlatformTime::Seconds() - startSeconds) * 1000.0 : -1.0;
+	});
+}
+
+void AutosaveService::FinishWrite() {
+
+	const double writeMs = inFlight.Get();
+	inFlight = TFuture<double>();
+
+	if (writeMs < 0.0) {
+		++failures;
+		UE_LOG(LogTemp, Warning, TEXT("Autosave to slot %s failed"), *slotName);
+		return;
+	}
+
+	// from the request to the data on disk, includes waiting behind the previous write
+	const double latencyMs = (FPlatformTime::Seconds() - requestSeconds) * 1000.0;
+
+	++writes;
+	latencySumMs += latencyMs;
+	maxLatencyMs = FMath::Max(maxLatencyMs, latencyMs);
+
+	SET_FLOAT_STAT(STAT_YetrixAutosaveWriteMs, writeMs);
+	SET_FLOAT_STAT(STAT_YetrixAutosaveLatencyMs, latencyMs);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Async.h"
+
+#include <vector>
+
+// Writes save games on a pool thread. Requests made while a write is running are coalesced, only the latest
+// one is written after it.
+class AutosaveService {
+public:
+	AutosaveService(const FString& theSlotName, int32 theUserIndex);
+
+	// game thread, data is a YetrixSimulation::SaveBinary snapshot
+	void Request(std::vector<uint8_t>&& data);
+
+	// game thread, picks up a finished write and starts the pending one
+	void Tick();
+
+	// blocks until everything requested so far is on disk
+	void Flush();
+
+	unsigned GetWrites() const {return writes;}
+	unsigned GetCoalesced() const {return coalesced;}
+	unsigned GetFailures() const {return failures;}
+	double GetAverageLatencyMs() const {return writes > 0 ? latencySumMs / writes : 0.0;}
+	double GetMaxLatencyMs() const {return maxLatencyMs;}
+
+private:
+	void StartWrite();
+	void FinishWrite();
+
+	FString slotName;
+	int32 userIndex = 0;
+
+	// milliseconds spent in SaveDataToSlot, negative if it failed
+	TFuture<double> inFlight;
+	double requestSeconds = 0.0;
+
+	std::vector<uint8_t> pendingData;
+	bool hasPending = false;
+	double pendingRequestSeconds = 0.0;
+
+	unsigned writes = 0;
+	unsigned coalesced = 0;
+	unsigned failures = 0;
+	double latencySumMs = 0.0;
+	double maxLatencyMs = 0.0;
+};
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "BlockActorPool.h"
+
+#include "Yetrix.h"
+#include "BlockBase.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Block pool hits"), STAT_YetrixBlockPoolHits, STATGROUP_Yetrix);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Block pool misses"), STAT_YetrixBlockPoolMisses, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Block pool free actors"), STAT_YetrixBlockPoolFree, STATGROUP_Yetrix);
+
+BlockActorPool::BlockActorPool(UWorld* theWorld, TSubclassOf<ABlockBase> theBlockClass) : world(theWorld), blockClass(theBlockClass) {
+}
+
+void BlockActorPool::Prewarm(const unsigned count) {
+
+	freeActors.reserve(freeActors.size() + count);
+
+	for (unsigned i = 0; i < count; ++i) {
+		auto* actor = Spawn(FVector::ZeroVector);
+		if (!actor)
+			return;
+
+		Park(actor);
+		freeActors.push_back(actor);
+	}
+
+	SET_DWORD_STAT(STAT_YetrixBlockPoolFree, freeActors.size());
+}
+
+void BlockActorPool::Clear() {
+
+	for (auto* actor : freeActors)
+		if (IsValid(actor))
+			actor->Destroy();
+
+	freeActors.clear();
+	SET_DWORD_STAT(STAT_YetrixBlockPoolFree, 0);
+}
+
+ABlockBase* BlockActorPool::Acquire(const FVector& location) {
+
+	while (!freeActors.empty()) {
+
+		auto* actor = freeActors.back();
+		freeActors.pop_back();
+
+		if (!IsValid(actor))
+			continue;
+
+		actor->SetActorLocation(location);
+		actor->SetActorHiddenInGame(false);
+		actor->SetActorEnableCollision(true);
+
+		++hits;
+		INC_DWORD_STAT(STAT_YetrixBlockPoolHits);
+		SET_DWORD_STAT(STAT_YetrixBlockPoolFree, freeActors.size());
+		return actor;
+	}
+
+	++misses;
+	INC_DWORD_STAT(STAT_YetrixBlockPoolMisses);
+	return Spawn(location);
+}
+
+void BlockActorPool::Release(ABlockBase* actor) {
+
+	if (!IsValid(actor))
+		return;
+
+	Park(actor);
+	freeActors.push_back(actor);
+	SET_DWORD_STAT(STAT_YetrixBlockPoolFree, freeActors.size());
+}
+
+ABlockBase* BlockActorPool::Spawn(const FVector& location) const {
+
+	if (!world)
+		return nullptr;
+
+	const FRotator rotator = FRotator::ZeroRotator;
+	const FActorSpawnParameters spawnParams;
+
+	return world->SpawnActor<ABlockBase>(blockClass, location, rotator, spawnParams);
+}
+
+void BlockActorPool::Park(ABlockBase* actor) {
+
+	actor->ResetEffects();
+	actor->SetActorHiddenInGame(true);
+	actor->SetActorEnableCollision(false);
+}
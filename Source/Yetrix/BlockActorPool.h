@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+
+class ABlockBase;
+
+// Recycles block actors instead of spawning and destroying one per block.
+class BlockActorPool {
+public:
+	BlockActorPool(UWorld* theWorld, TSubclassOf<ABlockBase> theBlockClass);
+
+	void Prewarm(unsigned count);
+	void Clear();
+
+	ABlockBase* Acquire(const FVector& location);
+	void Release(ABlockBase* actor);
+
+	unsigned GetHits() const {return hits;}
+	unsigned GetMisses() const {return misses;}
+	size_t GetFreeCount() const {return freeActors.size();}
+
+private:
+	ABlockBase* Spawn(const FVector& location) const;
+	static void Park(ABlockBase* actor);
+
+	UWorld* world = nullptr;
+	TSubclassOf<ABlockBase> blockClass;
+
+	// pooled actors stay referenced by the level, so raw pointers are fine while the world lives
+	std::vector<ABlockBase*> freeActors;
+
+	unsigned hits = 0;
+	unsigned misses = 0;
+};
@@ -0,0 +1,141 @@
+#include "BlockAnimator.h"
+
+#include "BlockView.h"
+
+void BlockAnimator::StartMove(BlockView* view, const FVector& from, const FVector& to, const float duration)
+{
+	if (duration <= 0.f)
+	{
+		if (view->moveSlot >= 0)
+			RemoveMove(view->moveSlot);
+
+		view->MoveActor(to);
+		WatchSettle(view);
+		return;
+	}
+
+	if (view->moveSlot < 0)
+	{
+		view->moveSlot = static_cast<int>(movingViews.size());
+		movingViews.push_back(view);
+		fromPositions.emplace_back();
+		toPositions.emplace_back();
+		durations.emplace_back();
+		timers.emplace_back();
+		previousPositions.emplace_back();
+		currentPositions.emplace_back();
+	}
+
+	const auto slot = view->moveSlot;
+	fromPositions[slot] = from;
+	toPositions[slot] = to;
+	durations[slot] = duration;
+	timers[slot] = duration;
+	previousPositions[slot] = from;
+	currentPositions[slot] = from;
+}
+
+bool BlockAnimator::IsMoving(const BlockView* view) const
+{
+	return view->moveSlot >= 0;
+}
+
+void BlockAnimator::WatchSettle(BlockView* view)
+{
+	if (view->settleSlot >= 0)
+		return;
+
+	view->settleSlot = static_cast<int>(settlingViews.size());
+	settlingViews.push_back(view);
+}
+
+void BlockAnimator::Forget(BlockView* view)
+{
+	if (view->moveSlot >= 0)
+		RemoveMove(view->moveSlot);
+
+	if (view->settleSlot >= 0)
+		RemoveSettle(view->settleSlot);
+}
+
+void BlockAnimator::Tick(const float dt)
+{
+	for (size_t slot = 0; slot < movingViews.size();)
+	{
+		// finished a step ago and presented on the way there, it rests at the destination now;
+		// the last one takes this slot, so it is looked at again
+		if (timers[slot] <= 0.f)
+		{
+			auto* view = movingViews[slot];
+			view->MoveActor(toPositions[slot]);
+			RemoveMove(slot);
+			WatchSettle(view);
+			continue;
+		}
+
+		timers[slot] -= dt;
+		if (timers[slot] < 0.f)
+			timers[slot] = 0.f;
+
+		const auto progress = 1.f - timers[slot] / durations[slot];
+		previousPositions[slot] = currentPositions[slot];
+		currentPositions[slot] = fromPositions[slot] + (toPositions[slot] - fromPositions[slot]) * progress;
+
+		++slot;
+	}
+
+	for (size_t slot = 0; slot < settlingViews.size();)
+	{
+		if (settlingViews[slot]->TrySettle(dt))
+			RemoveSettle(slot);
+		else
+			++slot;
+	}
+}
+
+void BlockAnimator::Present(const float alpha)
+{
+	for (size_t slot = 0; slot < movingViews.size(); ++slot)
+		movingViews[slot]->MoveActor(previousPositions[slot] + (currentPositions[slot] - previousPositions[slot]) * alpha);
+}
+
+void BlockAnimator::RemoveMove(const size_t slot)
+{
+	movingViews[slot]->moveSlot = -1;
+
+	const auto last = movingViews.size() - 1;
+	if (slot != last)
+	{
+		movingViews[slot] = movingViews[last];
+		fromPositions[slot] = fromPositions[last];
+		toPositions[slot] = toPositions[last];
+		durations[slot] = durations[last];
+		timers[slot] = timers[last];
+		previousPositions[slot] = previousPositions[last];
+		currentPositions[slot] = currentPositions[last];
+
+		movingViews[slot]->moveSlot = static_cast<int>(slot);
+	}
+
+	movingViews.pop_back();
+	fromPositions.pop_back();
+	toPositions.pop_back();
+	durations.pop_back();
+	timers.pop_back();
+	previousPositions.pop_back();
+	currentPositions.pop_back();
+}
+
+void BlockAnimator::RemoveSettle(const size_t slot)
+{
+	settlingViews[slot]->settleSlot = -1;
+
+	const auto last = settlingViews.size() - 1;
+	if (slot != last)
+	{
+		settlingViews[slot] = settlingViews[last];
+		settlingViews[slot]->settleSlot = static_cast<int>(slot);
+	}
+
+	settlingViews.pop_back();
+}
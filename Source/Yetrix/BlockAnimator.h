@@ -0,0 +1,46 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+
+class BlockView;
+
+// Runs block view animations. Only views with something going on are listed, so a frame costs
+// the number of moving or settling blocks, not the size of the stack.
+// Moves advance with the simulation steps and are drawn between the last two of them, see Present.
+class BlockAnimator {
+public:
+	// replaces a move the view already has
+	void StartMove(BlockView* view, const FVector& from, const FVector& to, float duration);
+	bool IsMoving(const BlockView* view) const;
+
+	// the view is checked every frame until it may give its actor back, see BlockView::TrySettle
+	void WatchSettle(BlockView* view);
+
+	// drops the view from both lists, e.g. when it is destroyed
+	void Forget(BlockView* view);
+
+	void Tick(float dt);
+
+	// puts moving actors between their previous and current step positions, alpha from 0 to 1
+	void Present(float alpha);
+
+	size_t GetMovingCount() const {return movingViews.size();}
+	size_t GetSettlingCount() const {return settlingViews.size();}
+
+private:
+	void RemoveMove(size_t slot);
+	void RemoveSettle(size_t slot);
+
+	// moves by slot, BlockView::moveSlot points back here
+	std::vector<BlockView*> movingViews;
+	std::vector<FVector> fromPositions;
+	std::vector<FVector> toPositions;
+	std::vector<float> durations;
+	std::vector<float> timers;
+	std::vector<FVector> previousPositions;
+	std::vector<FVector> currentPositions;
+
+	std::vector<BlockView*> settlingViews;
+};
@@ -3,6 +3,9 @@
 
 #include "BlockBase.h"
 
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#include "NiagaraComponent.h"
+
 // Sets default values
 ABlockBase::ABlockBase()
 {
@@ -25,3 +28,39 @@ void ABlockBase::Tick(float DeltaTime)
 
 }
 
+UGeometryCollectionComponent* ABlockBase::GetGeometryComponent() const
+{
+	TArray<UActorComponent*> components;
+	GetComponents(components);
+	constexpr int geometryComponentInd = 2;
+	if (components.Num() <= geometryComponentInd)
+		return nullptr;
+
+	return Cast<UGeometryCollectionComponent>(components[geometryComponentInd]);
+}
+
+UNiagaraComponent* ABlockBase::GetSmokeComponent() const
+{
+	TArray<UActorComponent*> components;
+	GetComponents(components);
+	constexpr int particleComponentInd = 3;
+	if (components.Num() <= particleComponentInd)
+		return nullptr;
+
+	return Cast<UNiagaraComponent>(components[particleComponentInd]);
+}
+
+void ABlockBase::ResetEffects() const
+{
+	auto* geometryComponent = GetGeometryComponent();
+	if (geometryComponent)
+	{
+		geometryComponent->SetSimulatePhysics(false);
+		geometryComponent->ResetDynamicCollection();
+		geometryComponent->RecreatePhysicsState();
+	}
+
+	auto* particleComponent = GetSmokeComponent();
+	if (particleComponent)
+		particleComponent->DeactivateImmediate();
+}
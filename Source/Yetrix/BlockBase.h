@@ -4,6 +4,9 @@
 #include "GameFramework/Actor.h"
 #include "BlockBase.generated.h"
 
+class UGeometryCollectionComponent;
+class UNiagaraComponent;
+
 UCLASS()
 class YETRIX_API ABlockBase : public AActor
 {
@@ -18,4 +21,9 @@ protected:
 public:	
 	virtual void Tick(float DeltaTime) override;
 
+	UGeometryCollectionComponent* GetGeometryComponent() const;
+	UNiagaraComponent* GetSmokeComponent() const;
+
+	// puts fractured geometry and particles back to the freshly spawned state, used when the actor is recycled
+	void ResetEffects() const;
 };
@@ -0,0 +1,238 @@
+#include "BlockView.h"
+
+#include "Yetrix.h"
+#include "YetrixConfig.h"
+#include "BlockBase.h"
+#include "BlockActorPool.h"
+#include "BlockAnimator.h"
+#include "FrozenBlockRenderer.h"
+#include "GeometryCollection/GeometryCollectionComponent.h"
+#include "Particles/ParticleSystemComponent.h"
+
+#include "NiagaraComponent.h"
+
+static TSubclassOf<ABlockBase> BlockBPClass;
+static BlockActorPool* ActorPool = nullptr;
+static FrozenBlockRenderer* FrozenRenderer = nullptr;
+static BlockAnimator* Animator = nullptr;
+
+bool BlockView::InitSubclasses() {
+
+	const bool wasNeedInit = !BlockBPClass.Get();
+	if (wasNeedInit) {
+		const ConstructorHelpers::FObjectFinder<UClass> blueprint_finder_BlockBP(TEXT("Blueprint'/Game/BlockBP.BlockBP_C'"));
+		BlockBPClass = (UClass*) blueprint_finder_BlockBP.Object;
+	}
+	
+	return wasNeedInit;
+}
+
+TSubclassOf<ABlockBase> BlockView::GetActorClass() {
+	return BlockBPClass;
+}
+
+void BlockView::SetActorPool(BlockActorPool* pool) {
+	ActorPool = pool;
+}
+
+void BlockView::SetFrozenRenderer(FrozenBlockRenderer* renderer) {
+	FrozenRenderer = renderer;
+}
+
+void BlockView::SetAnimator(BlockAnimator* animator) {
+	Animator = animator;
+}
+
+BlockView::BlockView(const Vec2D& thePosition, const bool isFrozen) : position(thePosition), frozen(isFrozen)
+{
+}
+
+FVector BlockView::ToWorldPosition(const Vec2D pos){
+
+	FVector worldPos;
+	worldPos.X = pos.x * blockSize;
+	worldPos.Y = 0.0;
+	worldPos.Z = pos.y * blockSize;
+
+	return worldPos;
+}
+
+BlockView::~BlockView() {
+	if (Animator)
+		Animator->Forget(this);
+
+	if (FrozenRenderer)
+		FrozenRenderer->RemoveInstance(this);
+
+	if (!IsValid(actor))
+		return;
+
+	if (ActorPool)
+		ActorPool->Release(actor);
+	else
+		actor->Destroy();
+}
+
+FVector BlockView::GetActorLocation() const
+{
+	if (!actor && FrozenRenderer)
+		return ToWorldPosition(position);
+		// drawn as an instance, resting at its logical position
+
+	if (!actor)
+	{
+		checkf(false, TEXT("BlockView::GetActorLocation error, no actor for block at %d, %d"), position.x, position.y);
+		return {0.f, 0.f, 0.f};
+	}
+
+	const auto& location = actor->GetActorLocation();
+	return location;
+}
+
+void BlockView::SetActorLocation(const FVector location)
+{
+	EnsureActor()->SetActorLocation(location);
+	WatchSettle();
+}
+
+void BlockView::SmokePuff()
+{
+	auto* particleComponent = EnsureActor()->GetSmokeComponent();
+	if (particleComponent)
+		particleComponent->ActivateSystem();
+
+	effectHoldTimer = smokePuffHoldDuration;
+	WatchSettle();
+}
+
+void BlockView::Explode()
+{
+	auto* geometryComponent = EnsureActor()->GetGeometryComponent();
+	if (geometryComponent)
+		geometryComponent->SetSimulatePhysics(true);
+}
+
+void BlockView::StartAnimatedMove(const float theAnimDuration, const FVector destination)
+{
+	const auto from = EnsureActor()->GetActorLocation();
+
+	if (Animator)
+		Animator->StartMove(this, from, destination, theAnimDuration);
+	else
+		MoveActor(destination);
+}
+
+void BlockView::SetPositionAndUpdateActor(const Vec2D& newPos, const float theAnimDuration) {
+
+	position = newPos;
+
+	if (theAnimDuration > 0.f)
+	{
+		const auto destination = ToWorldPosition(position);
+		StartAnimatedMove(theAnimDuration, destination);
+	}
+	else
+	{
+		UpdateActorFromLogicalPosition();
+	}		
+}
+
+void BlockView::Freeze() {
+
+	frozen = true;
+	WatchSettle();
+}
+
+void BlockView::StartDestroy() {
+
+	alive = false;
+	Explode();
+}
+
+ABlockBase* BlockView::CreateActor(UWorld* world) {
+
+	const FVector spawnLocation = ToWorldPosition(position);
+
+	if (FrozenRenderer && IsFrozen()) {
+		FrozenRenderer->SetInstance(this, spawnLocation);
+		return nullptr;
+	}
+
+	if (ActorPool) {
+		actor = ActorPool->Acquire(spawnLocation);
+		return actor;
+	}
+
+	const FRotator rotator = FRotator::ZeroRotator;
+	const FActorSpawnParameters spawnParams;
+
+	const auto newBlockActor = world->SpawnActor<ABlockBase>(BlockBPClass, spawnLocation, rotator, spawnParams);
+	actor = newBlockActor;
+	return actor;
+}
+
+ABlockBase* BlockView::EnsureActor()
+{
+	if (actor || !ActorPool)
+		return actor;
+
+	// promote from instance to a full actor at the resting position
+	actor = ActorPool->Acquire(ToWorldPosition(position));
+
+	if (FrozenRenderer)
+		FrozenRenderer->RemoveInstance(this);
+
+	return actor;
+}
+
+void BlockView::WatchSettle()
+{
+	if (Animator && FrozenRenderer && ActorPool && actor)
+		Animator->WatchSettle(this);
+}
+
+bool BlockView::TrySettle(const float dt)
+{
+	if (effectHoldTimer > 0.f)
+		effectHoldTimer -= dt;
+
+	if (!FrozenRenderer || !ActorPool || !actor)
+		return true;
+
+	// listed again when the move ends or the block freezes
+	if (!IsFrozen() || !IsAlive() || Animator->IsMoving(this))
+		return true;
+
+	if (effectHoldTimer > 0.f)
+		return false;
+
+	const auto restLocation = ToWorldPosition(position);
+	if (!actor->GetActorLocation().Equals(restLocation))
+		return false;
+		// still displaced by some visual effect, e.g. falling after a line clear
+
+	FrozenRenderer->SetInstance(this, restLocation);
+	ActorPool->Release(actor);
+	actor = nullptr;
+	return true;
+}
+
+void BlockView::UpdateActorFromLogicalPosition() const
+{
+	const auto resultPosition = ToWorldPosition(position);
+
+	if (!actor) {
+		if (FrozenRenderer && IsFrozen())
+			FrozenRenderer->SetInstance(this, resultPosition);
+
+		return;
+	}
+
+	actor->SetActorLocation(resultPosition);
+}
+
+void BlockView::MoveActor(const FVector& location) const
+{
+	if (actor)
+		actor->SetActorLocation(location);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <memory>
+#include "Utils.h"
+
+class ABlockBase;
+class BlockActorPool;
+class BlockAnimator;
+class FrozenBlockRenderer;
+
+// Actor side of a GameBlock: follows the logical block through SimulationPresenter calls and animates its actor.
+class BlockView {
+public:
+	typedef std::unique_ptr<BlockView> Ptr;
+
+	BlockView(const Vec2D& position, bool frozen);
+	~BlockView();
+
+	const Vec2D& GetPosition() const {return position;}
+	bool IsAlive() const {return alive;}
+	bool IsFrozen() const {return frozen;}
+
+	FVector GetActorLocation() const;
+	void SetActorLocation(const FVector location);
+
+	void SmokePuff();
+	void Explode();
+	void StartAnimatedMove(float theAnimDuration, FVector destination);
+
+	static bool InitSubclasses();
+	static TSubclassOf<ABlockBase> GetActorClass();
+
+	// actors are taken from and returned to the pool when set, spawned and destroyed otherwise
+	static void SetActorPool(BlockActorPool* pool);
+
+	// when set, resting frozen blocks give their actor back and are drawn as instances;
+	// any visual change (move, explosion, smoke) promotes them to a full actor again
+	static void SetFrozenRenderer(FrozenBlockRenderer* renderer);
+
+	// runs the moves and the settle checks; without one, moves jump straight to their destination
+	static void SetAnimator(BlockAnimator* animator);
+
+	static FVector ToWorldPosition(const Vec2D pos);
+
+	ABlockBase* CreateActor(UWorld* world);
+	void UpdateActorFromLogicalPosition() const;
+
+	// logical position only, the actor keeps whatever animation it has
+	void SetPosition(const Vec2D& newPos) {position = newPos;}
+	void SetPositionAndUpdateActor(const Vec2D& newPos, const float animDuration = 0.f);
+
+	void Freeze();
+	void StartDestroy();
+
+private:
+	friend class BlockAnimator;
+
+	ABlockBase* EnsureActor();
+	void MoveActor(const FVector& location) const;
+	void WatchSettle();
+
+	// true once there is nothing more to wait for: the actor went back to the pool or the block can't rest
+	bool TrySettle(float dt);
+
+	Vec2D position;
+	bool frozen = false;
+	bool alive = true;
+
+	float effectHoldTimer = 0.f;
+
+	// BlockAnimator list slots, -1 when not listed
+	int moveSlot = -1;
+	int settleSlot = -1;
+
+	ABlockBase* actor = nullptr;
+};
\ No newline at end of file
@@ -0,0 +1,376 @@
+#include "Autoplayer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+#include "FigureTables.h"
+#include "YetrixSimulation.h"
+#include "Zobrist.h"
+
+// condition score points one score point of cleared lines is worth
+static constexpr float lineRewardWeight = 0.5f;
+static constexpr float gameOverRating = 1000.f;
+
+// gives up steering and drops where the figure is, e.g. when a rotation is blocked on the way
+static constexpr int maxInputsPerFigure = 12;
+
+// new figures come in their spawn orientation, R0
+template <typename Board> static Vec2D GetSpawnPivot(const Figure::FigType type) {
+	return Figure::GetBlockPositions(type, {Board::spawnX, Board::spawnY}).front();
+}
+
+template <typename Board> static bool GetFigurePivot(const BasicBlockScene<Board>& scene, const Figure& figure, Vec2D& pivot) {
+
+	const auto& blockIDs = figure.GetBlockIDs();
+	if (blockIDs.size() != figureBlockCount || !FigureTables::HasType(figure.GetType()))
+		return false;
+
+	const auto block = scene.GetBlock(blockIDs[0]);
+	if (!block)
+		return false;
+
+	pivot = block->GetPosition();
+	return true;
+}
+
+static void RunSerially(const int count, const std::function<void(int)>& body) {
+
+	for (int i = 0; i < count; ++i)
+		body(i);
+}
+
+template <typename Board>
+BasicAutoplayer<Board>::BasicAutoplayer() : BasicAutoplayer(Settings()) {
+}
+
+template <typename Board>
+BasicAutoplayer<Board>::BasicAutoplayer(const Settings& theSettings) : settings(theSettings), parallelFor(RunSerially), ratingCache(autoplayerRatingCacheSizeLog2) {
+}
+
+template <typename Board>
+void BasicAutoplayer<Board>::SetParallelFor(ParallelForFunc func) {
+	parallelFor = func ? std::move(func) : RunSerially;
+}
+
+template <typename Board>
+typename BasicAutoplayer<Board>::Candidate BasicAutoplayer<Board>::Place(const Candidate& parent, const Placement::Positions& positions) {
+
+	Candidate candidate = parent;
+	for (const auto& pos : positions) {
+		if (pos.y >= Board::gridHeight)
+			continue;
+
+		candidate.rows[pos.y] |= static_cast<RowMask>(RowMask(1) << (pos.x - 1));
+		candidate.hash ^= Zobrist::GetCellKey<Board>(pos.x, pos.y, true);
+	}
+
+	// full rows go and the ones above fall, as after the destroy animation
+	int lines = 0;
+	int fallTo = 1;
+	for (int y = 1; y < Board::checkHeight; ++y) {
+		if (candidate.rows[y] == Board::fullRowMask) {
+			++lines;
+			continue;
+		}
+
+		candidate.rows[fallTo++] = candidate.rows[y];
+	}
+
+	for (; fallTo < Board::checkHeight; ++fallTo)
+		candidate.rows[fallTo] = 0;
+
+	// everything above moved, cheaper to hash again than to track
+	if (lines > 0) {
+		candidate.reward += scorePerCombo[std::min<size_t>(lines, scorePerCombo.size()) - 1];
+		candidate.hash = Zobrist::HashFrozenRows<Board>(candidate.rows);
+	}
+
+	return candidate;
+}
+
+template <typename Board>
+float BasicAutoplayer<Board>::RateRows(const Rows& rows) {
+
+	// cells a new figure takes, any frozen block there ends the game
+	constexpr RowMask spawnRowMask = static_cast<RowMask>(((RowMask(1) << FigureTables::spawnWidth) - 1) << (Board::spawnX - 1));
+
+	std::array<int, Board::rightBorderX> heights {};
+	int blocksCount = 0;
+
+	for (int y = 1; y < Board::gridHeight; ++y) {
+		RowMask row = rows[y];
+		blocksCount += Utils::CountSetBits(row);
+
+		for (; row; row &= row - 1)
+			heights[Utils::CountTrailingZeros(row) + 1] = y;
+	}
+
+	int maxHeight = 0;
+	int minHeight = -1;
+	int heightsSum = 0;
+
+	for (int x = 1; x < Board::rightBorderX; ++x) {
+		if (!heights[x])
+			continue;
+
+		maxHeight = std::max(maxHeight, heights[x]);
+		minHeight = minHeight < 0 ? heights[x] : std::min(minHeight, heights[x]);
+		heightsSum += heights[x];
+	}
+
+	// every empty cell under a column top is a hole
+	const int holes = heightsSum - blocksCount;
+
+	float rating =
+		conditionMaxHeightCoeff * maxHeight +
+		conditionMinHeightCoeff * std::max(minHeight, 0) +
+		conditionHolesCoeff * holes +
+		conditionBlocksCoeff * blocksCount;
+
+	for (int y = Board::spawnY - FigureTables::spawnHeight + 1; y <= Board::spawnY; ++y) {
+		if (rows[y] & spawnRowMask) {
+			rating += gameOverRating;
+			break;
+		}
+	}
+
+	return rating;
+}
+
+template <typename Board>
+float BasicAutoplayer<Board>::Rate(const Candidate& candidate) {
+
+	float rating = 0.f;
+	uint64_t cached = 0;
+
+	if (ratingCache.Find(candidate.hash, cached)) {
+		const uint32_t bits = static_cast<uint32_t>(cached);
+		std::memcpy(&rating, &bits, sizeof(rating));
+	}
+	else {
+		rating = RateRows(candidate.rows);
+
+		uint32_t bits = 0;
+		std::memcpy(&bits, &rating, sizeof(bits));
+		ratingCache.Store(candidate.hash, bits);
+	}
+
+	return rating - lineRewardWeight * candidate.reward;
+}
+
+template <typename Board>
+void BasicAutoplayer<Board>::TrimBeam(std::vector<Candidate>& candidates) const {
+
+	const auto byRating = [](const Candidate& first, const Candidate& second) { return first.rating < second.rating; };
+	const size_t keep = std::min(candidates.size(), static_cast<size_t>(std::max(settings.beamWidth, 1)));
+
+	std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), byRating);
+	candidates.resize(keep);
+}
+
+template <typename Board>
+typename BasicAutoplayer<Board>::SearchResult BasicAutoplayer<Board>::Search(const BasicBlockScene<Board>& scene, const Figure& figure, const std::vector<Figure::FigType>& preview) {
+
+	typedef std::chrono::steady_clock Clock;
+
+	SearchResult result;
+	const auto start = Clock::now();
+	const auto deadline = start + std::chrono::microseconds(static_cast<int64_t>(settings.budgetMs * 1000.f));
+
+	// set by whichever worker notices first, the unfinished layer is thrown away
+	std::atomic<bool> expired {false};
+	const auto isExpired = [&]() {
+		if (expired.load(std::memory_order_relaxed))
+			return true;
+
+		if (Clock::now() < deadline)
+			return false;
+
+		expired.store(true, std::memory_order_relaxed);
+		return true;
+	};
+
+	Vec2D pivot;
+	if (!GetFigurePivot(scene, figure, pivot))
+		return result;
+
+	Candidate root;
+	root.rows = Enumerator::GetFrozenRows(scene);
+	root.hash = Zobrist::HashFrozenRows<Board>(root.rows);
+
+	std::vector<Placement> rootPlacements;
+	Enumerator::Enumerate(root.rows, figure.GetType(), figure.GetOrientation(), pivot, rootPlacements);
+	if (rootPlacements.empty())
+		return result;
+
+	// the current figure is always rated in full, so there is a move whatever the budget
+	std::vector<Candidate> beam(rootPlacements.size());
+	parallelFor(static_cast<int>(beam.size()), [&](const int i) {
+		beam[i] = Place(root, rootPlacements[i].positions);
+		beam[i].rootMove = i;
+		beam[i].rating = Rate(beam[i]);
+	});
+
+	result.boardsRated += beam.size();
+	result.depth = 1;
+	TrimBeam(beam);
+
+	for (const auto type : preview) {
+
+		if (isExpired())
+			break;
+
+		const Vec2D spawnPivot = GetSpawnPivot<Board>(type);
+		std::vector<std::vector<Candidate>> children(beam.size());
+
+		parallelFor(static_cast<int>(beam.size()), [&](const int i) {
+
+			if (isExpired())
+				return;
+
+			std::vector<Placement> placements;
+			Enumerator::Enumerate(beam[i].rows, type, Figure::AngleCW::R0, spawnPivot, placements);
+
+			// no room for the figure, the game is over on this path
+			if (placements.empty()) {
+				Candidate lost = beam[i];
+				lost.rating += gameOverRating;
+				children[i].push_back(lost);
+				return;
+			}
+
+			children[i].reserve(placements.size());
+			for (const auto& placement : placements) {
+				Candidate child = Place(beam[i], placement.positions);
+				child.rating = Rate(child);
+				children[i].push_back(child);
+			}
+		});
+
+		if (expired)
+			break;
+
+		std::vector<Candidate> nextBeam;
+		for (const auto& parentChildren : children)
+			nextBeam.insert(nextBeam.end(), parentChildren.begin(), parentChildren.end());
+
+		result.boardsRated += nextBeam.size();
+		++result.depth;
+
+		TrimBeam(nextBeam);
+		beam = std::move(nextBeam);
+	}
+
+	int bestMove = beam.front().rootMove;
+
+	if (settings.expectUnknownFigure && !expired) {
+
+		static constexpr int figTypesCount = FigureTables::typesCount;
+
+		std::array<Vec2D, figTypesCount> spawnPivots;
+		for (int type = 0; type < figTypesCount; ++type)
+			spawnPivots[type] = GetSpawnPivot<Board>(static_cast<Figure::FigType>(type));
+
+		// every type is equally likely, each one is placed at its best
+		std::vector<float> expected(beam.size());
+		std::atomic<size_t> boardsRated {0};
+
+		parallelFor(static_cast<int>(beam.size()), [&](const int i) {
+
+			std::vector<Placement> placements;
+			float sum = 0.f;
+
+			for (int type = 0; type < figTypesCount; ++type) {
+
+				if (isExpired())
+					return;
+
+				placements.clear();
+				Enumerator::Enumerate(beam[i].rows, static_cast<Figure::FigType>(type), Figure::AngleCW::R0, spawnPivots[type], placements);
+
+				float best = beam[i].rating + gameOverRating;
+				for (const auto& placement : placements)
+					best = std::min(best, Rate(Place(beam[i], placement.positions)));
+
+				sum += best;
+				boardsRated += placements.size();
+			}
+
+			expected[i] = sum / figTypesCount;
+		});
+
+		result.boardsRated += boardsRated;
+
+		if (!expired) {
+			const auto bestIt = std::min_element(expected.begin(), expected.end());
+			bestMove = beam[bestIt - expected.begin()].rootMove;
+			++result.depth;
+		}
+	}
+
+	result.found = true;
+	result.placement = rootPlacements[bestMove];
+	result.timedOut = expired;
+
+	const std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+	result.elapsedMs = elapsed.count();
+
+	return result;
+}
+
+template <typename Board>
+void BasicAutoplayer<Board>::Drive(BasicYetrixSimulation<Board>& simulation) {
+
+	const auto& scene = *simulation.GetBlockScene();
+	const auto lowestFigID = scene.GetLowestFigureID();
+	if (lowestFigID == Utils::emptyID)
+		return;
+
+	const auto& figure = *scene.GetFigures().at(lowestFigID);
+
+	if (lowestFigID != plannedFigureID) {
+
+		plannedFigureID = lowestFigID;
+		plan = Search(scene, figure, simulation.PeekFigureTypes(settings.previewFigures));
+		inputsForFigure = 0;
+		dropRequested = false;
+
+		++searches;
+		timeouts += plan.timedOut ? 1 : 0;
+		totalSearchMs += plan.elapsedMs;
+		maxSearchMs = std::max(maxSearchMs, plan.elapsedMs);
+	}
+
+	// input is taken while the figure stands still, anything sent during a drop step would pile up
+	if (!plan.found || dropRequested || simulation.GetDropState() != BasicYetrixSimulation<Board>::DropState::STILL)
+		return;
+
+	Vec2D pivot;
+	if (!GetFigurePivot(scene, figure, pivot))
+		return;
+
+	// orientations covering the same cells are as good as the planned one
+	const auto& shape = FigureTables::Get(figure.GetType(), figure.GetOrientation());
+	const auto& targetShape = FigureTables::Get(figure.GetType(), plan.placement.orientation);
+
+	const int cornerX = pivot.x + shape.leftBottom.x;
+	const int targetCornerX = plan.placement.pivot.x + targetShape.leftBottom.x;
+	const bool sameShape = shape.cellMask == targetShape.cellMask;
+
+	if (++inputsForFigure > maxInputsPerFigure || (sameShape && cornerX == targetCornerX)) {
+		simulation.Drop();
+		dropRequested = true;
+	}
+	else if (!sameShape)
+		simulation.Rotate();
+	else if (cornerX > targetCornerX)
+		simulation.Left();
+	else
+		simulation.Right();
+}
+
+template class BasicAutoplayer<ClassicBoard>;
+template class BasicAutoplayer<WideBoard>;
+template class BasicAutoplayer<HugeBoard>;
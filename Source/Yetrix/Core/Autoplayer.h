@@ -0,0 +1,97 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "PlacementEnumerator.h"
+#include "TranspositionTable.h"
+
+template <typename Board> class BasicYetrixSimulation;
+
+// Plays the lowest figure. Beam search over its placements and those of the preview figures, then an expectation
+// over the first figure nobody knows yet. Boards are rated like BlockScene::CalculateSceneConditionScore, minus
+// the score of the lines they clear. Moves go through the same Left/Right/Rotate/Drop calls the player uses.
+// Compiled for the BoardGeometry presets, see the instantiations at the end of Autoplayer.cpp.
+template <typename Board> class BasicAutoplayer {
+public:
+	// runs body for every index in [0, count), in any order and on any threads
+	typedef std::function<void(int count, const std::function<void(int)>& body)> ParallelForFunc;
+
+	struct Settings {
+		int previewFigures = 2;
+		int beamWidth = 24;
+		bool expectUnknownFigure = true;
+
+		// the search returns the best move of the deepest finished layer once it runs past this
+		float budgetMs = 4.f;
+	};
+
+	struct SearchResult {
+		bool found = false;
+		Placement placement;
+
+		// finished layers, 1 is the current figure alone
+		int depth = 0;
+		bool timedOut = false;
+		size_t boardsRated = 0;
+		double elapsedMs = 0.0;
+	};
+
+	BasicAutoplayer();
+	explicit BasicAutoplayer(const Settings& theSettings);
+
+	// candidate boards are rated serially until a parallel for is given
+	void SetParallelFor(ParallelForFunc func);
+
+	SearchResult Search(const BasicBlockScene<Board>& scene, const Figure& figure, const std::vector<Figure::FigType>& preview);
+
+	// call before every YetrixSimulation::Tick: searches once per figure, then steers it one input per tick
+	void Drive(BasicYetrixSimulation<Board>& simulation);
+
+	unsigned GetSearches() const {return searches;}
+	unsigned GetTimeouts() const {return timeouts;}
+	double GetAverageSearchMs() const {return searches ? totalSearchMs / searches : 0.0;}
+	double GetMaxSearchMs() const {return maxSearchMs;}
+
+	// board ratings by Zobrist hash, kept between searches since most boards come back with the next figure
+	TranspositionTable::Stats GetRatingCacheStats() const {return ratingCache.GetStats();}
+
+private:
+	typedef BasicPlacementEnumerator<Board> Enumerator;
+	typedef typename Board::Rows Rows;
+	typedef typename Board::RowMask RowMask;
+
+	// a board the search reached
+	struct Candidate {
+		Rows rows {};
+		uint64_t hash = 0;
+		float reward = 0.f;
+		float rating = 0.f;
+		int rootMove = 0;
+	};
+
+	static Candidate Place(const Candidate& parent, const Placement::Positions& positions);
+	static float RateRows(const Rows& rows);
+	float Rate(const Candidate& candidate);
+
+	void TrimBeam(std::vector<Candidate>& candidates) const;
+
+	Settings settings;
+	ParallelForFunc parallelFor;
+	TranspositionTable ratingCache;
+
+	IDType plannedFigureID = Utils::emptyID;
+	SearchResult plan;
+	int inputsForFigure = 0;
+	bool dropRequested = false;
+
+	unsigned searches = 0;
+	unsigned timeouts = 0;
+	double totalSearchMs = 0.0;
+	double maxSearchMs = 0.0;
+};
+
+extern template class BasicAutoplayer<ClassicBoard>;
+extern template class BasicAutoplayer<WideBoard>;
+extern template class BasicAutoplayer<HugeBoard>;
+
+typedef BasicAutoplayer<ClassicBoard> Autoplayer;
@@ -0,0 +1,20 @@
+#include "Block.h"
+
+void GameBlock::Init(const BlockInfo& givenInfo)
+{
+	info = givenInfo;
+}
+
+bool GameBlock::SetPosition(const Vec2D& newPos)
+{
+	if (info.position == newPos)
+		return false;
+
+	info.position = newPos;
+	return true;
+}
+
+void GameBlock::StartDestroy() {
+
+	alive = false;
+}
\ No newline at end of file
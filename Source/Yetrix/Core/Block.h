@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include "Utils.h"
+
+class GameBlock : public std::enable_shared_from_this<GameBlock> {
+public:
+	typedef std::shared_ptr<GameBlock> Ptr;
+		
+	GameBlock() {
+	}
+
+	IDType GetID() const {return info.id;}
+	IDType GetFigureID() const {return info.figureID;}
+	const Vec2D& GetPosition() const {return info.position;}
+	bool IsAlive() const {return alive;}
+	bool IsFrozen() const {return info.figureID == Utils::emptyID;}
+
+	void SetFigure(const IDType figID) {info.figureID = figID;}
+
+	struct BlockInfo {
+		IDType id = Utils::emptyID;
+		Vec2D position;
+		IDType figureID;
+	};
+
+	void Init(const BlockInfo& givenInfo);
+
+	const BlockInfo& GetBlockInfo() const {return info;}
+
+private:
+	template <typename Board> friend class BasicBlockScene;
+
+	// position and destruction go through BlockScene, which keeps its cell index in sync
+	void StartDestroy();
+	bool SetPosition(const Vec2D& newPos);
+
+	BlockInfo info;
+	bool alive = true;
+};
\ No newline at end of file
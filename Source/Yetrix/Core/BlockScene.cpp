@@ -0,0 +1,941 @@
+#include "BlockScene.h"
+#include "YetrixConfig.h"
+#include <algorithm>
+#include <cassert>
+#include "Figure.h"
+#include "YetrixCheck.h"
+#include "FigureTables.h"
+
+#include "3rdparty/nlohmann/json.hpp"
+
+template <typename Board>
+BasicBlockScene<Board>::BasicBlockScene(){
+}
+
+template <typename Board>
+BasicBlockScene<Board>::~BasicBlockScene()
+{	
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::SetPresenter(SimulationPresenter* thePresenter) {
+	presenter = thePresenter ? thePresenter : &SimulationPresenter::Headless();
+}
+
+template <typename Board>
+Figure::Ptr BasicBlockScene<Board>::CreateFigureAt(Figure::FigType type, const Vec2D& pos) {
+
+	const IDType newFigureID = figures.insert(nullptr);
+	Figure::Ptr newFigurePtr = std::make_shared<Figure>(type, newFigureID);
+
+	const auto newBlocks = newFigurePtr->CreateBlocks(pos);
+
+	for (const auto& blockPtr : newBlocks) {
+		const bool canAddBlock = CanAddBlock(blockPtr);
+		if (!canAddBlock) {
+			figures.erase(newFigureID);
+			return nullptr;
+		}
+	}
+
+	std::vector<IDType> newBlockIDs;
+	for (const auto& blockPtr : newBlocks) {
+		const bool addedOk = AddBlock(blockPtr);
+		if (!addedOk) {
+			figures.erase(newFigureID);
+			return nullptr;
+		}
+
+		newBlockIDs.push_back(blockPtr->GetID());
+	}
+
+	newFigurePtr->SetBlockIDs(newBlockIDs);
+	figures.at(newFigureID) = newFigurePtr;
+	return newFigurePtr;
+}
+
+template <typename Board>
+Figure::Ptr BasicBlockScene<Board>::CreateRandomFigureAt(const Vec2D& pos, RandomStream& rnd) {
+
+	const Figure::FigType figType = DrawFigureType(rnd);
+	const auto figAdded = CreateFigureAt(figType, pos);
+	return figAdded;
+}
+
+template <typename Board>
+Figure::FigType BasicBlockScene<Board>::DrawFigureType(RandomStream& rnd) {
+
+	return static_cast<Figure::FigType> (rnd.NextBelow(FigureTables::typesCount));
+}
+
+template <typename Board>
+GameBlock::Ptr BasicBlockScene<Board>::GetBlock(const IDType blockID) const {
+	const auto* blockPtr = blocks.find(blockID);
+	if (!blockPtr)
+		return nullptr;
+
+	return *blockPtr;
+}
+
+template <typename Board>
+GameBlock::Ptr BasicBlockScene<Board>::GetBlock(const Vec2D& pos, bool aliveOnly) const {
+
+	if (IsInGrid(pos)) {
+		const auto& blockPtr = grid[GetGridIndex(pos)];
+		if (blockPtr || aliveOnly)
+			return blockPtr;
+	}
+
+	// blocks outside the grid (e.g. assembling ones) are not indexed
+	for (const auto& [id, blockPtr] : blocks)
+		if (blockPtr->GetPosition() == pos)
+			return blockPtr;
+
+	if (!aliveOnly)
+		for (const auto& dying : dyingBlocks)
+			if (dying.block->GetPosition() == pos)
+				return dying.block;
+
+	return nullptr;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::IsInGrid(const Vec2D& pos) {
+	return pos.x >= 0 && pos.x < Board::gridWidth && pos.y >= 0 && pos.y < Board::gridHeight;
+}
+
+template <typename Board>
+size_t BasicBlockScene<Board>::GetGridIndex(const Vec2D& pos) {
+	return static_cast<size_t>(pos.y) * Board::gridWidth + pos.x;
+}
+
+template <typename Board>
+typename BasicBlockScene<Board>::RowMask BasicBlockScene<Board>::GetColumnBit(const int x) {
+
+	if (x < 1 || x >= Board::rightBorderX)
+		return 0;
+
+	return static_cast<RowMask>(RowMask(1) << (x - 1));
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::IndexBlock(const GameBlock::Ptr& blockPtr) {
+
+	const auto& pos = blockPtr->GetPosition();
+	if (!IsInGrid(pos) || !blockPtr->IsAlive())
+		return;
+
+	grid[GetGridIndex(pos)] = blockPtr;
+
+	const bool frozen = blockPtr->GetFigureID() == Utils::emptyID;
+	SetFrozenCell(pos, frozen);
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::UnindexBlock(const GameBlock::Ptr& blockPtr) {
+
+	const auto& pos = blockPtr->GetPosition();
+	if (!IsInGrid(pos))
+		return;
+
+	// cell may already be taken by another block moved in earlier within the same batch
+	auto& cell = grid[GetGridIndex(pos)];
+	if (cell != blockPtr)
+		return;
+
+	cell = nullptr;
+	SetFrozenCell(pos, false);
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::SetFrozenCell(const Vec2D& pos, const bool frozen) {
+
+	const RowMask columnBit = GetColumnBit(pos.x);
+	const bool wasFrozen = (frozenRows[pos.y] & columnBit) != 0;
+	if (!columnBit || wasFrozen == frozen)
+		return;
+
+	if (frozen) {
+		frozenRows[pos.y] |= columnBit;
+		columnFrozenCounts[pos.x]++;
+		columnHeights[pos.x] = std::max(columnHeights[pos.x], pos.y);
+		return;
+	}
+
+	frozenRows[pos.y] &= ~columnBit;
+	columnFrozenCounts[pos.x]--;
+
+	// the top block went, the next one down is the new top
+	if (columnHeights[pos.x] == pos.y) {
+		int y = pos.y - 1;
+		while (y > 0 && !(frozenRows[y] & columnBit))
+			--y;
+
+		columnHeights[pos.x] = y;
+	}
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::RebuildGrid() {
+
+	grid.fill(nullptr);
+	frozenRows.fill(0);
+	columnHeights.fill(0);
+	columnFrozenCounts.fill(0);
+	for (const auto& [id, blockPtr] : blocks)
+		IndexBlock(blockPtr);
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::SetBlockPosition(GameBlock::Ptr blockPtr, const Vec2D& newPos) {
+
+	UnindexBlock(blockPtr);
+	const bool positionUpdated = blockPtr->SetPosition(newPos);
+	IndexBlock(blockPtr);
+
+	return positionUpdated;
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::MoveBlock(GameBlock::Ptr blockPtr, const Vec2D& newPos, const float animDuration) {
+
+	const bool positionUpdated = SetBlockPosition(blockPtr, newPos);
+	if (positionUpdated)
+		presenter->OnBlockMoved(*blockPtr, animDuration);
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::IsLaterExpiry(const DyingBlock& first, const DyingBlock& second) {
+	return first.expiresAt > second.expiresAt;
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::StartDestroy(GameBlock::Ptr blockPtr) {
+
+	UnindexBlock(blockPtr);
+	blockPtr->StartDestroy();
+
+	// the block keeps its ID for the presenter, the slot is free for new blocks
+	blocks.erase(blockPtr->GetID());
+	dyingBlocks.push_back({clock + destroyActorAfter, blockPtr});
+	std::push_heap(dyingBlocks.begin(), dyingBlocks.end(), IsLaterExpiry);
+
+	presenter->OnBlockDestroyStarted(*blockPtr);
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::CanAddBlock(const GameBlock::Ptr blockPtr) const
+{
+	const auto& blockPos = blockPtr->GetPosition();
+	const auto& existingBlock = GetBlock(blockPos, true);
+	const bool canAdd = existingBlock == nullptr;
+
+	return canAdd;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::AddBlock(GameBlock::Ptr blockPtr) {
+
+	const bool canAdd = CanAddBlock(blockPtr);
+	if (!canAdd)
+		return false;
+
+	blockPtr->info.id = blocks.insert(blockPtr);
+	IndexBlock(blockPtr);
+	presenter->OnBlockAdded(*blockPtr);
+	return true;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::FindRotation(const Figure& figure, Figure::AngleCW& orientation, Vec2D& pivot) const {
+
+	const auto& blockIDs = figure.GetBlockIDs();
+	if (blockIDs.size() != figureBlockCount || !FigureTables::HasType(figure.GetType()))
+		return false;
+
+	const auto pivotBlock = GetBlock(blockIDs[0]);
+	if (!pivotBlock)
+		return false;
+
+	static constexpr std::array<Figure::AngleCW, 3> turns = {Figure::AngleCW::R90, Figure::AngleCW::R180, Figure::AngleCW::R270};
+
+	for (const auto turn : turns) {
+
+		const auto turned = FigureTables::Turn(figure.GetOrientation(), turn);
+		const auto& shape = FigureTables::Get(figure.GetType(), turned);
+
+		for (const auto& kick : FigureTables::kicks) {
+			if (!FigureTables::Fits<Board>(frozenRows, shape, pivotBlock->GetPosition() + kick))
+				continue;
+
+			orientation = turned;
+			pivot = pivotBlock->GetPosition() + kick;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// saves keep block positions only, the orientation is whichever one they match
+template <typename Board>
+void BasicBlockScene<Board>::SetLoadedOrientation(Figure& figure) const {
+
+	std::vector<Vec2D> positions;
+	for (const auto blockID : figure.GetBlockIDs()) {
+		const auto blockPtr = GetBlock(blockID);
+		if (blockPtr)
+			positions.push_back(blockPtr->GetPosition());
+	}
+
+	figure.SetOrientation(FigureTables::FindOrientation(figure.GetType(), positions));
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::RotateFigure(const Figure::Ptr& figPtr) {
+
+	Figure::AngleCW orientation;
+	Vec2D pivot;
+	if (!FindRotation(*figPtr, orientation, pivot))
+		return false;
+
+	const auto& cells = FigureTables::Get(figPtr->GetType(), orientation).cells;
+	const auto& blockIDs = figPtr->GetBlockIDs();
+
+	for (size_t i = 0; i < blockIDs.size(); ++i)
+		SetBlockPosition(blocks.at(blockIDs[i]), pivot + cells[i]);
+
+	figPtr->SetOrientation(orientation);
+	return true;
+}
+
+template <typename Board>
+typename BasicBlockScene<Board>::ConditionInfo BasicBlockScene<Board>::GetConditionInfo() const
+{
+	ConditionInfo info;
+	int heightsSum = 0;
+	int frozenCount = 0;
+
+	for (int x = 1; x < Board::rightBorderX; ++x)
+	{
+		const int height = columnHeights[x];
+		if (!height)
+			continue;
+
+		info.maxHeight = std::max(info.maxHeight, height);
+		info.minHeight = info.minHeight < 0 ? height : std::min(info.minHeight, height);
+		heightsSum += height;
+		frozenCount += columnFrozenCounts[x];
+	}
+
+	// cells under the column tops without a frozen block, less the ones a falling figure fills
+	info.holes = heightsSum - frozenCount;
+
+	for (const auto& [figID, figPtr] : figures)
+		for (const auto blockID : figPtr->GetBlockIDs())
+		{
+			const auto& pos = blocks.at(blockID)->GetPosition();
+			if (IsInGrid(pos) && pos.y > 0 && pos.y < columnHeights[pos.x] && grid[GetGridIndex(pos)])
+				info.holes--;
+		}
+
+	if (info.minHeight < 0)
+		info.minHeight = 0;
+
+	return info;
+}
+
+template <typename Board>
+typename BasicBlockScene<Board>::ConditionInfo BasicBlockScene<Board>::ComputeSceneConditionInfo() const
+{
+	ConditionInfo info;
+
+	std::map<int, int> heightMap;
+		
+	for (const auto& [id, blockInfo]: blocks)
+	{
+		if (blockInfo->GetBlockInfo().figureID != Utils::emptyID)
+			continue;
+			// block is not frozen yet
+
+		const auto& pos = blockInfo->GetPosition();
+		const auto x = pos.x;
+		const auto y = pos.y;
+
+		if (info.maxHeight < y)
+			info.maxHeight = y;
+
+		if (heightMap.count(x) == 0 || heightMap.at(x) < y)
+		{
+			heightMap[x] = y;			
+		}
+
+	}
+
+	for (const auto [x, y] : heightMap)
+	{
+		if (info.minHeight < 0 || info.minHeight > y)
+				info.minHeight = y;
+	}
+	
+	for (int x = 1; x < Board::rightBorderX; ++x)
+	{
+		if (heightMap.count(x) == 0)
+			continue;
+			// no blocks on this column
+
+		int y = heightMap.at(x) - 1;
+		for (; y > 0; --y)
+		{
+			auto block = GetBlock({x, y}, true);
+			if (!block)
+			{
+				info.holes++;
+			}
+		}
+	}
+
+	if (info.minHeight < 0)
+		info.minHeight = 0;
+
+	return info;
+}
+
+template <typename Board>
+int BasicBlockScene<Board>::CalculateSceneConditionScore() const
+{
+	const auto conditionInfo = GetConditionInfo();
+
+	// checked builds compare the incremental state with a full recompute
+	YETRIX_CHECKF(conditionInfo == ComputeSceneConditionInfo(), "BlockScene::CalculateSceneConditionScore error, incremental column data differs from a full recompute");
+
+	const int resultScore = 
+		conditionMaxHeightCoeff * conditionInfo.maxHeight + 
+		conditionMinHeightCoeff * conditionInfo.minHeight + 
+		conditionHolesCoeff * conditionInfo.holes + 
+		conditionBlocksCoeff * blocks.size();
+
+	return resultScore;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::DeconstructFigures() {
+
+	std::set<IDType> figuresToDeconstruct;
+
+	for (const auto& [id, figPtr] : figures) {
+		
+		unsigned maxHeight = 0;
+		const bool canDrop = CheckFigureCanMove(figPtr, {0, -1}, maxHeight);
+		if (!canDrop)
+			figuresToDeconstruct.insert(id);
+	}
+
+	for (auto figID : figuresToDeconstruct) {
+		const auto& fig = figures.at(figID);
+
+		const auto& blockIDs = fig->GetBlockIDs();
+		for (const auto blockID : blockIDs) {
+			const auto block = GetBlock(blockID);
+			block->SetFigure(Utils::emptyID);
+			IndexBlock(block);
+			presenter->OnBlockFrozen(*block);
+		}
+
+		figures.erase(figID);
+	}
+
+	const bool deconstructed = !figuresToDeconstruct.empty();
+	return deconstructed;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::TryMoveBlock(const Vec2D& direction) {
+
+	const auto lowestFigID = GetLowestFigureID();
+
+	if (lowestFigID == Utils::emptyID)
+		return false;
+
+	const auto* figurePtr = figures.find(lowestFigID);
+	if (!figurePtr)
+	{
+		YETRIX_CHECKF(false, "BlockScene::TryMoveBlock error, no lowest figure");
+		return false;
+	}
+
+	const auto& figure = *figurePtr;
+	unsigned distance = 0;
+	const bool canMove = CheckFigureCanMove(figure, direction, distance);
+
+	if (!canMove)
+		return false;
+
+	const auto& blockIDs = figure->GetBlockIDs();
+	for (const auto blockID : blockIDs) {
+		const auto block = GetBlock(blockID);
+		const auto& prevPos = block->GetPosition();
+		const auto newPos = prevPos + direction;
+		MoveBlock(block, newPos, moveLeftRightAnimDuration);
+	}
+
+	presenter->OnFigureMoved(*figure, direction);
+	return true;
+}
+
+template <typename Board>
+std::map<IDType, Vec2D> BasicBlockScene<Board>::GetFallingPositions(const std::set<int>& destroyedLines) const {
+
+	std::map<IDType, Vec2D> fallingPositions;
+	int fallAccum = 0;
+
+	for (int y = 1; y < Board::checkHeight; ++y) {
+		
+		const bool isLineDestroyed = destroyedLines.count(y) > 0;
+		if (isLineDestroyed) {
+			++fallAccum;
+			continue;
+		}
+
+		if (fallAccum == 0)
+			continue;
+
+		// the whole frozen row shifts down by fallAccum
+		const int newY = y - fallAccum;
+		RowMask rowMask = frozenRows[y];
+
+		while (rowMask) {
+			const int x = Utils::CountTrailingZeros(rowMask) + 1;
+			rowMask &= rowMask - 1;
+
+			const auto& block = grid[GetGridIndex({x, y})];
+			fallingPositions.insert({block->GetID(), {x, newY}});
+		}
+	}
+
+	return fallingPositions;
+}
+
+template <typename Board>
+typename BasicBlockScene<Board>::RowMask BasicBlockScene<Board>::GetFrozenRow(const int y) const {
+
+	if (y < 0 || y >= Board::gridHeight)
+		return 0;
+
+	return frozenRows[y];
+}
+
+template <typename Board>
+std::set<int> BasicBlockScene<Board>::GetFullRows() const {
+
+	std::set<int> fullRows;
+
+	for (int y = 1; y < Board::checkHeight; ++y)
+		if (frozenRows[y] == fullRowMask)
+			fullRows.insert(y);
+
+	return fullRows;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::CheckFigureBlockCanBePlaced(const Vec2D& position) const
+{
+
+	const bool positionBoundsOk = Board::IsInside(position.x, position.y);
+	if (!positionBoundsOk)
+		return false;
+
+	const auto& blockAtPosition = GetBlock(position, true);
+	if (!blockAtPosition)
+		return true;
+
+	const bool belongsToExistingFigure = blockAtPosition->GetFigureID() != Utils::emptyID;
+	const bool free = belongsToExistingFigure;
+	return free;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::CheckBlockCanMove(GameBlock::Ptr blockPtr, Vec2D direction, unsigned& maxDistance) const
+{
+	const Vec2D blockPos = blockPtr->GetPosition();
+	Vec2D farest = {blockPos.x, blockPos.y};
+
+	bool currOk;
+	do {
+		farest = farest + direction;
+		currOk = CheckFigureBlockCanBePlaced(farest);
+		++maxDistance;
+	}
+	while(currOk);
+	
+	--maxDistance;
+	farest = farest - direction;
+	const bool canDrop = blockPos != farest;
+	return canDrop;
+}
+
+// above the top of its column a block falls onto the top or the floor, under an overhang it walks down
+template <typename Board>
+unsigned BasicBlockScene<Board>::GetBlockDropDistance(const GameBlock::Ptr& blockPtr) const
+{
+	const auto& pos = blockPtr->GetPosition();
+
+	if (!Board::IsInside(pos.x, pos.y) || pos.y <= columnHeights[pos.x]) {
+		unsigned distance = 0;
+		CheckBlockCanMove(blockPtr, {0, -1}, distance);
+		return distance;
+	}
+
+	const unsigned distance = pos.y - columnHeights[pos.x] - 1;
+
+	// debug builds check the heights against the walk
+	assert([&]() { unsigned walked = 0; CheckBlockCanMove(blockPtr, {0, -1}, walked); return walked == distance; }());
+
+	return distance;
+}
+
+template <typename Board>
+unsigned BasicBlockScene<Board>::GetFigureDropDistance(const Figure& figure) const
+{
+	unsigned distance = std::numeric_limits<int>::max();
+	for (const auto blockID : figure.GetBlockIDs())
+		distance = std::min(distance, GetBlockDropDistance(GetBlock(blockID)));
+
+	return distance;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::CheckFigureCanMove(const Figure::Ptr figPtr, const Vec2D direction, unsigned& maxDistance) const
+{
+	if (direction == Vec2D(0, -1)) {
+		maxDistance = GetFigureDropDistance(*figPtr);
+		return maxDistance > 0;
+	}
+
+	const auto& figBlockIDs = figPtr->GetBlockIDs();
+	maxDistance = std::numeric_limits<int>::max();
+	for (auto& blockID : figBlockIDs) {
+		const auto blockPtr = GetBlock(blockID);
+		
+		unsigned maxDistForBlock = 0;
+		const bool canMoveBlock = CheckBlockCanMove(blockPtr, direction, maxDistForBlock);
+		if (!canMoveBlock) {
+			maxDistance = 0;
+			return false;
+		}
+		maxDistance = std::min(maxDistForBlock, maxDistance);
+	}
+
+	const bool canDrop = maxDistance > 0;
+	return canDrop;
+}
+
+template <typename Board>
+IDType BasicBlockScene<Board>::GetLowestFigureID() const
+{	
+	IDType lowestFigID = Utils::emptyID;
+	int lowestBlockY = std::numeric_limits<int>::max();
+
+	for (const auto& [id, figPtr] : figures) {
+
+		const auto& blockIDs = figPtr->GetBlockIDs();
+		for (const auto blockID : blockIDs) {
+
+			const auto& block = GetBlock(blockID);
+			const auto& blockPos = block->GetPosition();
+
+			if (lowestBlockY > blockPos.y) {
+				lowestBlockY = blockPos.y;
+				lowestFigID = id;
+			}
+		}
+	}
+
+	return lowestFigID;
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::Tick(const float dt)
+{
+	clock += dt;
+	CleanupBlocks();
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::CleanupBlocks() {
+
+	while (!dyingBlocks.empty() && dyingBlocks.front().expiresAt < clock) {
+		std::pop_heap(dyingBlocks.begin(), dyingBlocks.end(), IsLaterExpiry);
+		presenter->OnBlockRemoved(dyingBlocks.back().block->GetID());
+		dyingBlocks.pop_back();
+	}
+}
+
+template <typename Board>
+json BasicBlockScene<Board>::Save() const
+{
+	json doc;
+	doc["blocks"] = json::object();
+
+	for (const auto [id, blockPtr] : blocks)
+	{
+		json& blockObject = doc["blocks"][id.ToString()];
+		const auto& blockInfo = blockPtr->GetBlockInfo();
+
+		json& posObject = blockObject["pos"];
+		posObject["x"] = blockInfo.position.x;
+		posObject["y"] = blockInfo.position.y;
+
+		if (blockInfo.figureID != Utils::emptyID)
+			blockObject["figure"] = blockInfo.figureID.ToString();
+	}
+	
+	doc["figures"] = json::object();
+	for (const auto [id, figurePtr] : figures)
+	{
+		json& figureObject = doc["figures"][id.ToString()];
+		figureObject["type"] = figurePtr->GetType();
+
+		figureObject["blocks"] = json::array();
+		json& blocksObj = figureObject["blocks"];
+
+		for (const auto blockID : figurePtr->GetBlockIDs())
+		{
+			if (blocks.count(blockID) == 0)
+			{
+				YETRIX_CHECKF(false, "BlockScene::Save error, figure refers to a block which doesn't exist. Cannot save game properly");
+				continue;
+			}
+
+			blocksObj.push_back(blockID.ToString());
+		}
+	}
+
+	return doc;
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::Clear()
+{
+	for (const auto& [id, blockPtr] : blocks)
+		presenter->OnBlockRemoved(id);
+
+	for (const auto& dying : dyingBlocks)
+		presenter->OnBlockRemoved(dying.block->GetID());
+
+	figures.clear();
+	blocks.clear();
+	dyingBlocks.clear();
+	RebuildGrid();
+}
+
+template <typename Board>
+GameBlock::Ptr BasicBlockScene<Board>::InsertLoadedBlock(const GameBlock::BlockInfo& blockInfo)
+{
+	// no placement checks, the grid is rebuilt after the whole scene is read
+	const GameBlock::Ptr newBlock = std::make_shared<GameBlock>();
+	newBlock->Init(blockInfo);
+
+	newBlock->info.id = blocks.insert(newBlock);
+	presenter->OnBlockAdded(*newBlock);
+	return newBlock;
+}
+
+// rows are stored at the width of their mask, the classic board keeps the 16 bit rows of earlier saves
+template <typename RowMask> static void WriteRow(ByteWriter& writer, const RowMask row) {
+
+	if constexpr (sizeof(RowMask) == sizeof(uint16_t))
+		writer.U16(row);
+	else if constexpr (sizeof(RowMask) == sizeof(uint32_t))
+		writer.U32(row);
+	else
+		writer.U64(row);
+}
+
+template <typename RowMask> static RowMask ReadRow(ByteReader& reader) {
+
+	if constexpr (sizeof(RowMask) == sizeof(uint16_t))
+		return reader.U16();
+	else if constexpr (sizeof(RowMask) == sizeof(uint32_t))
+		return reader.U32();
+	else
+		return reader.U64();
+}
+
+template <typename Board>
+void BasicBlockScene<Board>::SaveBinary(ByteWriter& writer) const
+{
+	int rowsCount = Board::gridHeight;
+	while (rowsCount > 0 && frozenRows[rowsCount - 1] == 0)
+		--rowsCount;
+
+	writer.VarInt(rowsCount);
+	for (int y = 0; y < rowsCount; ++y)
+		WriteRow(writer, frozenRows[y]);
+
+	writer.VarInt(figures.size());
+	for (const auto& [id, figurePtr] : figures)
+	{
+		// block order matters, the first block is the rotation pivot
+		const auto& blockIDs = figurePtr->GetBlockIDs();
+
+		writer.U8(static_cast<uint8_t>(figurePtr->GetType()));
+		writer.VarInt(blockIDs.size());
+
+		for (const auto blockID : blockIDs)
+		{
+			const auto& pos = blocks.at(blockID)->GetPosition();
+			writer.SignedVarInt(pos.x);
+			writer.SignedVarInt(pos.y);
+		}
+	}
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::LoadBinary(ByteReader& reader)
+{
+	Clear();
+
+	const uint64_t rowsCount = reader.VarInt();
+	if (!reader.IsOk() || rowsCount > Board::gridHeight)
+		return false;
+
+	for (int y = 0; y < static_cast<int>(rowsCount); ++y)
+	{
+		RowMask rowMask = ReadRow<RowMask>(reader) & fullRowMask;
+
+		while (rowMask) {
+			const int x = Utils::CountTrailingZeros(rowMask) + 1;
+			rowMask &= rowMask - 1;
+
+			GameBlock::BlockInfo blockInfo;
+			blockInfo.position = {x, y};
+			InsertLoadedBlock(blockInfo);
+		}
+	}
+
+	const uint64_t figuresCount = reader.VarInt();
+	if (!reader.IsOk() || figuresCount > reader.Remaining())
+	{
+		Clear();
+		return false;
+	}
+
+	for (uint64_t figureInd = 0; figureInd < figuresCount; ++figureInd)
+	{
+		const uint8_t figType = reader.U8();
+		const uint64_t blocksCount = reader.VarInt();
+		if (!reader.IsOk() || !FigureTables::HasType(static_cast<Figure::FigType>(figType)) || blocksCount > reader.Remaining())
+		{
+			Clear();
+			return false;
+		}
+
+		const IDType figID = figures.insert(nullptr);
+		const auto newFigurePtr = std::make_shared<Figure>(static_cast<Figure::FigType>(figType), figID);
+		figures.at(figID) = newFigurePtr;
+
+		std::vector<IDType> blockIds;
+		for (uint64_t blockInd = 0; blockInd < blocksCount; ++blockInd)
+		{
+			GameBlock::BlockInfo blockInfo;
+			blockInfo.position.x = static_cast<int>(reader.SignedVarInt());
+			blockInfo.position.y = static_cast<int>(reader.SignedVarInt());
+			blockInfo.figureID = figID;
+
+			blockIds.push_back(InsertLoadedBlock(blockInfo)->GetID());
+		}
+
+		newFigurePtr->SetBlockIDs(blockIds);
+		SetLoadedOrientation(*newFigurePtr);
+	}
+
+	if (!reader.IsOk())
+	{
+		Clear();
+		return false;
+	}
+
+	RebuildGrid();
+	return true;
+}
+
+template <typename Board>
+bool BasicBlockScene<Board>::Load(const json& data)
+{
+	Clear();
+
+	const json& doc = data;
+
+	// saved ids are only meaningful inside the save (older saves used random strings), so fresh handles are issued
+	std::map<std::string, IDType> figureIDs;
+	std::map<std::string, IDType> blockIDs;
+
+	const json& figuresObj = doc["figures"];
+	for (json::const_iterator figureIt = figuresObj.begin(); figureIt != figuresObj.end(); ++figureIt)
+	{
+		const json& figObj = figureIt.value();
+		const auto figType = figObj["type"].get<int>();
+
+		const IDType figID = figures.insert(nullptr);
+		figures.at(figID) = std::make_shared<Figure>(static_cast<Figure::FigType>(figType), figID);
+		figureIDs[figureIt.key()] = figID;
+	}
+
+	const json& blocksObj = doc["blocks"];
+
+	for (json::const_iterator blockIt = blocksObj.begin(); blockIt != blocksObj.end(); ++blockIt)
+	{
+		const json& blockObj = blockIt.value();
+		GameBlock::BlockInfo blockInfo;
+
+		if (blockObj.contains("figure"))
+		{
+			const auto savedFigureID = blockObj["figure"].get<std::string>();
+			const auto figIDIt = figureIDs.find(savedFigureID);
+			if (figIDIt == figureIDs.end())
+			{
+				YETRIX_CHECKF(false, "BlockScene::Load error, block refers to a figure which doesn't exist. Cannot load game properly");
+				continue;
+			}
+
+			blockInfo.figureID = figIDIt->second;
+		}
+
+		blockInfo.position.x = blockObj["pos"]["x"].get<int>();
+		blockInfo.position.y = blockObj["pos"]["y"].get<int>();
+
+		const auto newBlock = InsertLoadedBlock(blockInfo);
+		blockIDs[blockIt.key()] = newBlock->GetID();
+	}
+
+	for (json::const_iterator figureIt = figuresObj.begin(); figureIt != figuresObj.end(); ++figureIt)
+	{
+		const auto& newFigurePtr = figures.at(figureIDs.at(figureIt.key()));
+
+		std::vector<IDType> blockIds;
+		const json& blockIDsObj = figureIt.value()["blocks"];
+		for (json::const_iterator blockIDsIt = blockIDsObj.begin(); blockIDsIt != blockIDsObj.end(); ++blockIDsIt) {
+
+			const auto savedBlockID = blockIDsIt.value().get<std::string>();
+			const auto blockIDIt = blockIDs.find(savedBlockID);
+			if (blockIDIt == blockIDs.end())
+			{
+				YETRIX_CHECKF(false, "BlockScene::Load error, figure refers to a block which doesn't exist. Cannot load game properly");
+				continue;
+			}
+
+			blockIds.push_back(blockIDIt->second);
+		}
+
+		newFigurePtr->SetBlockIDs(blockIds);
+		SetLoadedOrientation(*newFigurePtr);
+	}
+
+	RebuildGrid();
+	return true;
+}
+
+template class BasicBlockScene<ClassicBoard>;
+template class BasicBlockScene<WideBoard>;
+template class BasicBlockScene<HugeBoard>;
\ No newline at end of file
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <set>
+#include <map>
+#include <array>
+#include "Utils.h"
+#include "SlotMap.h"
+#include "YetrixConfig.h"
+#include "BoardGeometry.h"
+#include "Figure.h"
+#include "SimulationPresenter.h"
+#include "ByteStream.h"
+
+#include "3rdparty/nlohmann/json_fwd.hpp"
+
+using json = nlohmann::json;
+
+// Blocks and figures on a board of the given BoardGeometry. Sources are compiled for the presets only,
+// see the instantiations at the end of BlockScene.cpp.
+template <typename Board> class BasicBlockScene {
+
+public:
+	BasicBlockScene();
+	~BasicBlockScene();
+
+	void SetPresenter(SimulationPresenter* thePresenter);
+
+	Figure::Ptr CreateRandomFigureAt(const Vec2D& pos, RandomStream& rnd);
+	static Figure::FigType DrawFigureType(RandomStream& rnd);
+
+	GameBlock::Ptr GetBlock(const Vec2D& pos, bool aliveOnly) const;
+	GameBlock::Ptr GetBlock(IDType blockID) const;
+
+	typedef SlotMap<std::shared_ptr<Figure> > FigureMap;
+	typedef SlotMap<std::shared_ptr<GameBlock> > BlockMap;
+
+	FigureMap& GetFigures() {return figures;}
+	BlockMap& GetBlocks() {return blocks;}
+	const FigureMap& GetFigures() const {return figures;}
+	const BlockMap& GetBlocks() const {return blocks;}
+
+	// exploding blocks, out of GetBlocks from StartDestroy until the presenter is told to remove them
+	size_t GetDyingBlocksCount() const {return dyingBlocks.size();}
+
+	struct ConditionInfo
+	{
+		// empty cells under the top frozen block of their column
+		int holes = 0;
+		int maxHeight = 0;
+		int minHeight = -1;
+
+		bool operator==(const ConditionInfo& second) const {
+			return holes == second.holes && maxHeight == second.maxHeight && minHeight == second.minHeight;
+		}
+	};
+
+	// from column heights and counts kept up to date with the grid, no cell probing
+	ConditionInfo GetConditionInfo() const;
+
+	int CalculateSceneConditionScore() const;
+
+	json Save() const;
+	bool Load(const json& data);
+
+	// frozen blocks as a row bitmap, then every figure as its type and block positions
+	void SaveBinary(ByteWriter& writer) const;
+	bool LoadBinary(ByteReader& reader);
+
+	// removes everything, the presenter is told about every removed block
+	void Clear();
+
+	bool DeconstructFigures();
+	IDType GetLowestFigureID() const;
+
+	void Tick(float dt);
+	
+	bool CheckFigureCanMove(Figure::Ptr figPtr, Vec2D direction, unsigned& maxDistance) const;
+
+	// rows the figure can fall, from the column heights; also where a ghost preview of the figure goes
+	unsigned GetFigureDropDistance(const Figure& figure) const;
+	bool TryMoveBlock(const Vec2D& direction);
+
+	// first turn (R90, R180, R270) and kick the figure fits with, read from FigureTables; false if none does
+	bool FindRotation(const Figure& figure, Figure::AngleCW& orientation, Vec2D& pivot) const;
+
+	// moves the figure's blocks to the found rotation and keeps its orientation, no animation
+	bool RotateFigure(const Figure::Ptr& figPtr);
+	std::map<IDType, Vec2D> GetFallingPositions(const std::set<int>& destroyedLines) const;
+
+	typedef typename Board::RowMask RowMask;
+	static constexpr RowMask fullRowMask = Board::fullRowMask;
+
+	RowMask GetFrozenRow(int y) const;
+	std::set<int> GetFullRows() const;
+
+	bool SetBlockPosition(GameBlock::Ptr blockPtr, const Vec2D& newPos);
+
+	// same as SetBlockPosition, but the presenter is told to show the move
+	void MoveBlock(GameBlock::Ptr blockPtr, const Vec2D& newPos, float animDuration = 0.f);
+	void StartDestroy(GameBlock::Ptr blockPtr);
+
+protected:	
+	bool CanAddBlock(GameBlock::Ptr blockPtr) const;
+	bool AddBlock(GameBlock::Ptr blockPtr);
+	bool CheckFigureBlockCanBePlaced(const Vec2D& position) const;
+	bool CheckBlockCanMove(GameBlock::Ptr blockPtr, Vec2D direction, unsigned& maxDistance) const;
+	unsigned GetBlockDropDistance(const GameBlock::Ptr& blockPtr) const;
+	void CleanupBlocks();
+	Figure::Ptr CreateFigureAt(Figure::FigType type, const Vec2D& pos);
+	void SetLoadedOrientation(Figure& figure) const;
+
+private:
+	static bool IsInGrid(const Vec2D& pos);
+	static size_t GetGridIndex(const Vec2D& pos);
+	static RowMask GetColumnBit(int x);
+
+	void IndexBlock(const GameBlock::Ptr& blockPtr);
+	void UnindexBlock(const GameBlock::Ptr& blockPtr);
+	void RebuildGrid();
+	void SetFrozenCell(const Vec2D& pos, bool frozen);
+	GameBlock::Ptr InsertLoadedBlock(const GameBlock::BlockInfo& blockInfo);
+
+	ConditionInfo ComputeSceneConditionInfo() const;
+
+	FigureMap figures;
+
+	// alive blocks only
+	BlockMap blocks;
+
+	struct DyingBlock {
+		double expiresAt = 0.0;
+		GameBlock::Ptr block;
+	};
+
+	// heap order, the first block to expire on top
+	static bool IsLaterExpiry(const DyingBlock& first, const DyingBlock& second);
+
+	std::vector<DyingBlock> dyingBlocks;
+
+	// sum of Tick times, what dying blocks expire against
+	double clock = 0.0;
+
+	SimulationPresenter* presenter = &SimulationPresenter::Headless();
+
+	// alive blocks by cell, kept in sync with block positions
+	std::array<GameBlock::Ptr, Board::gridWidth * Board::gridHeight> grid;
+
+	// frozen (figure-less) alive blocks per row, maintained together with the grid
+	typename Board::Rows frozenRows {};
+
+	// top frozen row and frozen block count per column, follow frozenRows
+	std::array<int, Board::gridWidth> columnHeights {};
+	std::array<int, Board::gridWidth> columnFrozenCounts {};
+};
+
+extern template class BasicBlockScene<ClassicBoard>;
+extern template class BasicBlockScene<WideBoard>;
+extern template class BasicBlockScene<HugeBoard>;
+
+// the scene the game runs on
+typedef BasicBlockScene<ClassicBoard> BlockScene;
\ No newline at end of file
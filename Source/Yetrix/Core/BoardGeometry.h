@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "YetrixConfig.h"
+
+// Playfield size as a type. Columns 1..width and rows from 1 up are inside, column 0, column rightBorderX
+// and row 0 are the borders. Rows below checkHeight are checked for lines, figures spawn above them.
+template <int Width, int CheckHeight> struct BoardGeometry {
+
+	// a figure fits at spawn, a frozen row fits one of the mask types
+	static_assert(Width >= 4 && Width <= 64);
+	static_assert(CheckHeight > 1);
+
+	static constexpr int width = Width;
+	static constexpr int rightBorderX = Width + 1;
+	static constexpr int checkHeight = CheckHeight;
+
+	static constexpr int spawnX = Width / 2;
+	static constexpr int spawnY = CheckHeight + 4;
+
+	// cell index of the scene, covers the playfield, its borders and the spawn area
+	static constexpr int gridWidth = rightBorderX + 1;
+	static constexpr int gridHeight = spawnY + 8;
+
+	// frozen blocks of a row, bit (x - 1) for column x, in the narrowest type that holds them
+	typedef std::conditional_t<Width <= 16, uint16_t, std::conditional_t<Width <= 32, uint32_t, uint64_t>> RowMask;
+	static constexpr RowMask fullRowMask = static_cast<RowMask>(static_cast<RowMask>(~RowMask(0)) >> (sizeof(RowMask) * 8 - Width));
+
+	typedef std::array<RowMask, gridHeight> Rows;
+
+	// open above, figures spawn there
+	static constexpr bool IsInside(const int x, const int y) {
+		return x >= 1 && x <= width && y >= 1;
+	}
+};
+
+// the board of the game, as set in YetrixConfig.h
+typedef BoardGeometry<rightBorderX - 1, checkHeight> ClassicBoard;
+
+typedef BoardGeometry<16, 24> WideBoard;
+
+// widest rows there are, for stress runs
+typedef BoardGeometry<64, 128> HugeBoard;
+
+// saves and replays of the game depend on where figures spawn
+static_assert(ClassicBoard::spawnX == 5 && ClassicBoard::spawnY == 24 && ClassicBoard::gridHeight == 32);
+static_assert(std::is_same_v<ClassicBoard::RowMask, uint16_t> && ClassicBoard::fullRowMask == 0x3FF);
+static_assert(WideBoard::fullRowMask == 0xFFFF && HugeBoard::fullRowMask == ~0ull);
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Little-endian writer for the binary formats (replays, saves).
+class ByteWriter {
+public:
+	explicit ByteWriter(std::vector<uint8_t>& theOut) : out(theOut) {}
+
+	void U8(const uint8_t value) { out.push_back(value); }
+	void U16(const uint16_t value) { Fixed(value, 2); }
+	void U32(const uint32_t value) { Fixed(value, 4); }
+	void U64(const uint64_t value) { Fixed(value, 8); }
+
+	// LEB128, small values take one byte
+	void VarInt(uint64_t value) {
+		while (value >= 0x80) {
+			out.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back(static_cast<uint8_t>(value));
+	}
+
+	// zigzag, small negative values stay small too
+	void SignedVarInt(const int64_t value) {
+		VarInt((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+	}
+
+	void Bytes(const void* data, const size_t size) {
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		out.insert(out.end(), bytes, bytes + size);
+	}
+
+private:
+	void Fixed(const uint64_t value, const int size) {
+		for (int i = 0; i < size; ++i)
+			out.push_back(static_cast<uint8_t>(value >> (i * 8)));
+	}
+
+	std::vector<uint8_t>& out;
+};
+
+// Bounds-checked counterpart of ByteWriter. An overrun returns zeros and clears IsOk(), so a parser can read
+// a whole record and check once.
+class ByteReader {
+public:
+	ByteReader(const uint8_t* theData, const size_t theSize) : data(theData), size(theSize) {}
+
+	uint8_t U8() {
+		if (pos >= size) {
+			ok = false;
+			return 0;
+		}
+		return data[pos++];
+	}
+
+	uint16_t U16() { return static_cast<uint16_t>(Fixed(2)); }
+	uint32_t U32() { return static_cast<uint32_t>(Fixed(4)); }
+	uint64_t U64() { return Fixed(8); }
+
+	uint64_t VarInt() {
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7) {
+			const uint8_t byte = U8();
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		ok = false;
+		return 0;
+	}
+
+	int64_t SignedVarInt() {
+		const uint64_t value = VarInt();
+		return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+	}
+
+	// pointer to the next count bytes, nullptr if there are fewer left
+	const uint8_t* Bytes(const uint64_t count) {
+		if (count > Remaining()) {
+			ok = false;
+			return nullptr;
+		}
+
+		const uint8_t* bytes = data + pos;
+		pos += static_cast<size_t>(count);
+		return bytes;
+	}
+
+	bool Expect(const void* expected, const size_t count) {
+		const uint8_t* bytes = Bytes(count);
+		return bytes && std::memcmp(bytes, expected, count) == 0;
+	}
+
+	size_t Remaining() const { return size - pos; }
+	bool IsOk() const { return ok; }
+
+private:
+	uint64_t Fixed(const int count) {
+		uint64_t value = 0;
+		for (int i = 0; i < count; ++i)
+			value |= static_cast<uint64_t>(U8()) << (i * 8);
+		return value;
+	}
+
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	size_t pos = 0;
+	bool ok = true;
+};
\ No newline at end of file
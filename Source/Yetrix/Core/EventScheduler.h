@@ -0,0 +1,74 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Simulation events by the tick they are due at, kept as a min-heap. Ties go by event value, then by
+// scheduling order, so the same input always gives the same order and replays stay exact.
+template <typename EventType> class EventScheduler {
+
+	struct Entry {
+		uint64_t dueTick = 0;
+		uint64_t sequence = 0;
+		EventType event {};
+	};
+
+	// heap order, the first event to fire on top
+	static bool IsLater(const Entry& first, const Entry& second) {
+
+		if (first.dueTick != second.dueTick)
+			return first.dueTick > second.dueTick;
+
+		if (first.event != second.event)
+			return first.event > second.event;
+
+		return first.sequence > second.sequence;
+	}
+
+public:
+	// ticks of this scheduler, the owner calls Advance at the start of each one
+	void Advance() {++now;}
+	uint64_t GetNow() const {return now;}
+
+	// zero ticks still means the next one, events don't fire in the tick that scheduled them
+	void ScheduleAfter(const uint64_t ticks, const EventType event) {
+
+		entries.push_back({now + std::max<uint64_t>(ticks, 1), nextSequence++, event});
+		std::push_heap(entries.begin(), entries.end(), IsLater);
+	}
+
+	// every pending event of this value
+	void Cancel(const EventType event) {
+
+		const auto removed = std::remove_if(entries.begin(), entries.end(), [event](const Entry& entry) { return entry.event == event; });
+		if (removed == entries.end())
+			return;
+
+		entries.erase(removed, entries.end());
+		std::make_heap(entries.begin(), entries.end(), IsLater);
+	}
+
+	bool IsScheduled(const EventType event) const {
+		return std::any_of(entries.begin(), entries.end(), [event](const Entry& entry) { return entry.event == event; });
+	}
+
+	// the first event due by now, false when nothing is
+	bool PopDue(EventType& event) {
+
+		if (entries.empty() || entries.front().dueTick > now)
+			return false;
+
+		std::pop_heap(entries.begin(), entries.end(), IsLater);
+		event = entries.back().event;
+		entries.pop_back();
+		return true;
+	}
+
+	size_t GetPendingCount() const {return entries.size();}
+
+private:
+	std::vector<Entry> entries;
+	uint64_t now = 0;
+	uint64_t nextSequence = 0;
+};
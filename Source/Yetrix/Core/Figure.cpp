@@ -0,0 +1,36 @@
+#include "Figure.h"
+#include "FigureTables.h"
+
+std::vector<GameBlock::Ptr> Figure::CreateBlocks(const Vec2D& leftTop) {
+
+	std::vector<GameBlock::Ptr> newBlocks;
+
+	for (const auto& position : GetBlockPositions(type, leftTop)) {
+
+		GameBlock::BlockInfo newBlockInfo;
+		newBlockInfo.position = position;
+		newBlockInfo.figureID = GetID();
+
+		GameBlock::Ptr newBlock = std::make_shared<GameBlock>();
+		newBlock->Init(newBlockInfo);
+
+		newBlocks.push_back(newBlock);
+	}
+
+	return newBlocks;
+}
+
+std::vector<Vec2D> Figure::GetBlockPositions(const FigType type, const Vec2D& leftTop) {
+
+	if (!FigureTables::HasType(type))
+		return {};
+
+	std::vector<Vec2D> positions;
+	for (const auto& offset : FigureTables::spawnOffsets[static_cast<size_t>(type)])
+		positions.push_back(leftTop + offset);
+
+	return positions;
+}
+
+Figure::~Figure() {
+}
\ No newline at end of file
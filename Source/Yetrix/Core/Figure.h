@@ -1,9 +1,11 @@
 #pragma once
+#include <vector>
 #include "Block.h"
 #include "Utils.h"
 
 class Figure : public std::enable_shared_from_this<Figure> {
 public:
+	// indices into FigureTables::shapes, named for the classic set; a larger set goes on past HAT by index
 	enum class FigType {
 		LONG,
 		LEFT_BOOT,
@@ -12,16 +14,19 @@ public:
 		LEFT_GUN,
 		RIGHT_GUN,
 		HAT,
-		UNDEFINED
+		UNDEFINED = 255
 	};
 
 	typedef std::shared_ptr<Figure> Ptr;
 
-	~Figure();
+	enum class AngleCW {
+		R0,
+		R90,
+		R180,
+		R270
+	};
 
-	explicit Figure(const FigType newFigType) : type(newFigType) {
-		id = Utils::NewID();
-	}
+	~Figure();
 
 	explicit Figure(const FigType newFigType, const IDType givenId) : id(givenId), type(newFigType) {
 	}
@@ -29,20 +34,21 @@ public:
 	IDType GetID() const { return id; }
 	FigType GetType() const {return type; }
 
-	std::vector<GameBlock::Ptr> CreateBlocks(const Vec2D& leftTop, UWorld* world);
+	std::vector<GameBlock::Ptr> CreateBlocks(const Vec2D& leftTop);
+
+	// where CreateBlocks puts the blocks, in the same order
+	static std::vector<Vec2D> GetBlockPositions(FigType type, const Vec2D& leftTop);
 	const std::vector<IDType>& GetBlockIDs() const { return blockIDs; }
 
 	void SetBlockIDs(const std::vector<IDType>& ids) {blockIDs = ids;}
 
-	enum class AngleCW {
-		R0,
-		R90,
-		R180,
-		R270
-	};
+	// quarter turns from the spawn shape, picks the row of FigureTables
+	AngleCW GetOrientation() const {return orientation;}
+	void SetOrientation(const AngleCW theOrientation) {orientation = theOrientation;}
 		
 private:
 	std::vector<IDType> blockIDs;
 	IDType id = Utils::emptyID;
 	FigType type = FigType::UNDEFINED;
+	AngleCW orientation = AngleCW::R0;
 };
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include "Figure.h"
+#include "BoardGeometry.h"
+#include "YetrixConfig.h"
+
+// Shape data per figure type and orientation, built at compile time. Orientation counts clockwise quarter turns
+// from the spawn shape. Cells are relative to the pivot, the figure's first block, and keep the block order.
+// Another set, e.g. pentominoes, takes new rows in shapes and a new figureBlockCount; sizes, the type count
+// and the spawn area follow from them, FitsSpawnArea tells whether a board has room for it. Every shape of
+// a set has exactly figureBlockCount cells, sets mixing cell counts aren't supported: block arrays per
+// figure are sized by it.
+namespace FigureTables {
+
+	constexpr int orientationsCount = 4;
+
+	// any polyomino of figureBlockCount cells fits a box this wide and tall
+	constexpr int shapeBoxSize = figureBlockCount;
+
+	// bit (row * shapeBoxSize + column), rows from the top, columns from the left
+	typedef uint64_t ShapeMask;
+	static_assert(shapeBoxSize * shapeBoxSize <= 64);
+
+	// spawn shapes by FigType, top row first, one binary literal per row: its last shapeBoxSize digits are
+	// the columns, left to right. Empty rows and columns around a shape don't matter.
+	typedef std::array<uint32_t, shapeBoxSize> ShapeRows;
+
+	constexpr ShapeRows shapes[] = {
+		{0b1111},         // LONG
+		{0b1000, 0b1110}, // LEFT_BOOT
+		{0b0010, 0b1110}, // RIGHT_BOOT
+		{0b1100, 0b1100}, // BOX
+		{0b0110, 0b1100}, // LEFT_GUN
+		{0b1100, 0b0110}, // RIGHT_GUN
+		{0b0100, 0b1110}  // HAT
+	};
+
+	// rows past the named FigType values are addressed by index
+	constexpr int typesCount = static_cast<int>(std::size(shapes));
+	static_assert(typesCount < static_cast<int>(Figure::FigType::UNDEFINED), "FigType::UNDEFINED must stay out of the table");
+
+	constexpr ShapeMask CellBit(const int cell) {
+		return ShapeMask(1) << cell;
+	}
+
+	constexpr ShapeMask MakeShapeMask(const ShapeRows& rows) {
+
+		ShapeMask mask = 0;
+		for (int row = 0; row < shapeBoxSize; ++row)
+			for (int column = 0; column < shapeBoxSize; ++column)
+				if (rows[row] >> (shapeBoxSize - 1 - column) & 1u)
+					mask |= CellBit(row * shapeBoxSize + column);
+
+		return mask;
+	}
+
+	constexpr bool IsConnected(const ShapeMask mask) {
+
+		ShapeMask reached = mask & (~mask + 1);
+		for (int step = 1; step < shapeBoxSize * shapeBoxSize; ++step) {
+			for (int cell = 0; cell < shapeBoxSize * shapeBoxSize; ++cell) {
+				if (!(reached >> cell & 1u))
+					continue;
+
+				const int column = cell % shapeBoxSize;
+				if (column > 0)
+					reached |= mask & CellBit(cell - 1);
+				if (column < shapeBoxSize - 1)
+					reached |= mask & CellBit(cell + 1);
+				if (cell >= shapeBoxSize)
+					reached |= mask & CellBit(cell - shapeBoxSize);
+				if (cell + shapeBoxSize < shapeBoxSize * shapeBoxSize)
+					reached |= mask & CellBit(cell + shapeBoxSize);
+			}
+		}
+
+		return reached == mask;
+	}
+
+	// figureBlockCount connected cells, no digits beyond the box
+	constexpr bool IsValidShape(const ShapeRows& rows) {
+
+		for (const auto row : rows)
+			if (row >> shapeBoxSize)
+				return false;
+
+		const ShapeMask mask = MakeShapeMask(rows);
+
+		int cellsCount = 0;
+		for (ShapeMask rest = mask; rest; rest &= rest - 1)
+			++cellsCount;
+
+		return cellsCount == figureBlockCount && IsConnected(mask);
+	}
+
+	constexpr bool AreValidShapes() {
+
+		for (const auto& rows : shapes)
+			if (!IsValidShape(rows))
+				return false;
+
+		return true;
+	}
+
+	static_assert(AreValidShapes(), "every shape needs figureBlockCount connected cells inside the box");
+
+	// pivot shifts tried in order when a turned figure doesn't fit in place, the same for every type
+	constexpr std::array<Vec2D, 5> kicks = {{{0, 0}, {1, 0}, {-1, 0}, {0, -1}, {0, 1}}};
+
+	struct Orientation {
+		std::array<Vec2D, figureBlockCount> cells;
+
+		// bounding box, its left bottom corner relative to the pivot
+		Vec2D leftBottom;
+		int width = 0;
+		int height = 0;
+
+		// cells by bounding box row, bit dx for column dx
+		std::array<uint32_t, shapeBoxSize> rowMasks {};
+
+		// all cells, bit (dy * shapeBoxSize + dx), equal for orientations covering the same cells
+		ShapeMask cellMask = 0;
+	};
+
+	constexpr Vec2D Rotate(const int quarterTurns, const Vec2D& coord) {
+
+		Vec2D rotated = coord;
+		for (int i = 0; i < quarterTurns; ++i)
+			rotated = {rotated.y, -rotated.x};
+
+		return rotated;
+	}
+
+	constexpr Figure::AngleCW Turn(const Figure::AngleCW orientation, const Figure::AngleCW turn) {
+		return static_cast<Figure::AngleCW>((static_cast<int>(orientation) + static_cast<int>(turn)) % orientationsCount);
+	}
+
+	typedef std::array<Vec2D, figureBlockCount> SpawnOffsets;
+
+	// from the left top corner of the shape, x right and y up; column by column, top to bottom, which is
+	// the order of Figure::CreateBlocks, so the first cell is the pivot
+	constexpr SpawnOffsets MakeSpawnOffsets(const ShapeRows& rows) {
+
+		const ShapeMask mask = MakeShapeMask(rows);
+
+		int left = shapeBoxSize;
+		int top = shapeBoxSize;
+		for (int cell = 0; cell < shapeBoxSize * shapeBoxSize; ++cell) {
+			if (!(mask >> cell & 1u))
+				continue;
+
+			left = cell % shapeBoxSize < left ? cell % shapeBoxSize : left;
+			top = cell / shapeBoxSize < top ? cell / shapeBoxSize : top;
+		}
+
+		SpawnOffsets offsets {};
+		size_t count = 0;
+
+		for (int column = left; column < shapeBoxSize; ++column)
+			for (int row = top; row < shapeBoxSize; ++row)
+				if (mask >> (row * shapeBoxSize + column) & 1u)
+					offsets[count++] = {column - left, top - row};
+
+		return offsets;
+	}
+
+	constexpr std::array<SpawnOffsets, typesCount> MakeSpawnOffsetsTable() {
+
+		std::array<SpawnOffsets, typesCount> table {};
+		for (int type = 0; type < typesCount; ++type)
+			table[type] = MakeSpawnOffsets(shapes[type]);
+
+		return table;
+	}
+
+	inline constexpr std::array<SpawnOffsets, typesCount> spawnOffsets = MakeSpawnOffsetsTable();
+
+	constexpr Orientation MakeOrientation(const SpawnOffsets& offsets, const int quarterTurns) {
+
+		Orientation orientation;
+
+		Vec2D rightTop;
+		for (size_t i = 0; i < offsets.size(); ++i) {
+
+			const Vec2D cell = Rotate(quarterTurns, offsets[i] - offsets[0]);
+			orientation.cells[i] = cell;
+
+			if (i == 0) {
+				orientation.leftBottom = cell;
+				rightTop = cell;
+				continue;
+			}
+
+			orientation.leftBottom = {cell.x < orientation.leftBottom.x ? cell.x : orientation.leftBottom.x, cell.y < orientation.leftBottom.y ? cell.y : orientation.leftBottom.y};
+			rightTop = {cell.x > rightTop.x ? cell.x : rightTop.x, cell.y > rightTop.y ? cell.y : rightTop.y};
+		}
+
+		orientation.width = rightTop.x - orientation.leftBottom.x + 1;
+		orientation.height = rightTop.y - orientation.leftBottom.y + 1;
+
+		for (const auto& cell : orientation.cells) {
+			const Vec2D local = cell - orientation.leftBottom;
+			orientation.rowMasks[local.y] |= 1u << local.x;
+			orientation.cellMask |= CellBit(local.y * shapeBoxSize + local.x);
+		}
+
+		return orientation;
+	}
+
+	typedef std::array<std::array<Orientation, orientationsCount>, typesCount> OrientationTable;
+
+	constexpr OrientationTable MakeOrientationTable() {
+
+		OrientationTable table {};
+		for (int type = 0; type < typesCount; ++type)
+			for (int quarterTurns = 0; quarterTurns < orientationsCount; ++quarterTurns)
+				table[type][quarterTurns] = MakeOrientation(spawnOffsets[type], quarterTurns);
+
+		return table;
+	}
+
+	inline constexpr OrientationTable orientations = MakeOrientationTable();
+
+	constexpr int MaxSpawnExtent(const bool vertical) {
+
+		int extent = 0;
+		for (const auto& typeOrientations : orientations) {
+			const auto& spawn = typeOrientations[0];
+			extent = (vertical ? spawn.height : spawn.width) > extent ? (vertical ? spawn.height : spawn.width) : extent;
+		}
+
+		return extent;
+	}
+
+	// area new figures take, from the spawn point right and down
+	constexpr int spawnWidth = MaxSpawnExtent(false);
+	constexpr int spawnHeight = MaxSpawnExtent(true);
+
+	// the area lies between the borders, above the checked rows, with room in the grid to turn
+	template <typename Board> constexpr bool FitsSpawnArea() {
+		return Board::spawnX >= 1 && Board::spawnX + spawnWidth <= Board::rightBorderX &&
+			Board::spawnY - spawnHeight + 1 >= Board::checkHeight &&
+			Board::spawnY + shapeBoxSize <= Board::gridHeight;
+	}
+
+	static_assert(FitsSpawnArea<ClassicBoard>() && FitsSpawnArea<WideBoard>() && FitsSpawnArea<HugeBoard>(), "spawn area doesn't fit a board preset");
+
+	// loaded saves may carry any number as a type
+	constexpr bool HasType(const Figure::FigType type) {
+		return static_cast<unsigned>(type) < static_cast<unsigned>(typesCount);
+	}
+
+	constexpr const Orientation& Get(const Figure::FigType type, const Figure::AngleCW orientation) {
+		return orientations[static_cast<size_t>(type)][static_cast<size_t>(orientation)];
+	}
+
+	// against frozen rows (bit x - 1 for column x), the borders and the floor; nothing is frozen above the rows
+	template <typename Board, typename RowsType> bool Fits(const RowsType& rows, const Orientation& orientation, const Vec2D& pivot) {
+
+		const int left = pivot.x + orientation.leftBottom.x;
+		const int bottom = pivot.y + orientation.leftBottom.y;
+
+		if (left < 1 || left + orientation.width > Board::rightBorderX || bottom < 1)
+			return false;
+
+		const int rowsCount = static_cast<int>(rows.size());
+		for (int dy = 0; dy < orientation.height && bottom + dy < rowsCount; ++dy)
+			if (rows[bottom + dy] & (static_cast<typename Board::RowMask>(orientation.rowMasks[dy]) << (left - 1)))
+				return false;
+
+		return true;
+	}
+
+	// orientation whose cells match the positions, pivot first; R0 if none does
+	inline Figure::AngleCW FindOrientation(const Figure::FigType type, const std::vector<Vec2D>& positions) {
+
+		if (positions.size() != figureBlockCount || !HasType(type))
+			return Figure::AngleCW::R0;
+
+		for (int quarterTurns = 0; quarterTurns < orientationsCount; ++quarterTurns) {
+
+			const auto& cells = orientations[static_cast<size_t>(type)][quarterTurns].cells;
+
+			bool matches = true;
+			for (size_t i = 0; i < cells.size() && matches; ++i)
+				matches = positions[i] - positions[0] == cells[i];
+
+			if (matches)
+				return static_cast<Figure::AngleCW>(quarterTurns);
+		}
+
+		return Figure::AngleCW::R0;
+	}
+
+	// the named types only mean their shapes with the classic set
+	constexpr bool classicShapes = figureBlockCount == 4 && typesCount == static_cast<int>(Figure::FigType::HAT) + 1;
+
+	static_assert(!classicShapes || Get(Figure::FigType::BOX, Figure::AngleCW::R0).cellMask == Get(Figure::FigType::BOX, Figure::AngleCW::R270).cellMask);
+	static_assert(!classicShapes || Get(Figure::FigType::LONG, Figure::AngleCW::R0).cellMask == Get(Figure::FigType::LONG, Figure::AngleCW::R180).cellMask);
+	static_assert(!classicShapes || Get(Figure::FigType::LONG, Figure::AngleCW::R90).height == 4);
+}
@@ -0,0 +1,147 @@
+#include "InputLog.h"
+
+#include "ByteStream.h"
+#include "YetrixSimulation.h"
+
+#include "3rdparty/nlohmann/json.hpp"
+
+static constexpr char replayMagic[4] = {'Y', 'R', 'P', 'L'};
+static constexpr uint8_t replayVersion = 2;
+
+// version 1 had no input buffer window, its presses waited as long as it took
+static constexpr uint8_t replayVersionUnbuffered = 1;
+
+void InputLog::Start(const uint64_t theSeed, const std::string& theSnapshot, const uint64_t theStartTick, const uint64_t theInputBufferTicks) {
+
+	seed = theSeed;
+	snapshot = theSnapshot;
+	startTick = theStartTick;
+	inputBufferTicks = theInputBufferTicks;
+	length = 0;
+	records.clear();
+}
+
+void InputLog::Add(const uint64_t tick, const InputType type) {
+
+	records.push_back({tick - startTick, type});
+}
+
+void InputLog::Finish(const uint64_t tick) {
+
+	length = tick - startTick;
+}
+
+std::vector<uint8_t> InputLog::Serialize() const {
+
+	std::vector<uint8_t> out;
+	out.reserve(32 + snapshot.size() + records.size() * 2);
+
+	ByteWriter writer(out);
+	writer.Bytes(replayMagic, sizeof(replayMagic));
+	writer.U8(replayVersion);
+
+	writer.U64(seed);
+	writer.VarInt(length);
+	writer.VarInt(inputBufferTicks);
+
+	writer.VarInt(snapshot.size());
+	writer.Bytes(snapshot.data(), snapshot.size());
+
+	writer.VarInt(records.size());
+
+	uint64_t prevTick = 0;
+	for (const auto& record : records) {
+		writer.VarInt(record.tick - prevTick);
+		writer.U8(static_cast<uint8_t>(record.type));
+		prevTick = record.tick;
+	}
+
+	return out;
+}
+
+bool InputLog::Deserialize(const uint8_t* data, const size_t size) {
+
+	ByteReader reader(data, size);
+	if (!reader.Expect(replayMagic, sizeof(replayMagic)))
+		return false;
+
+	const uint8_t version = reader.U8();
+	if (version != replayVersion && version != replayVersionUnbuffered)
+		return false;
+
+	const uint64_t newSeed = reader.U64();
+	const uint64_t newLength = reader.VarInt();
+	const uint64_t newInputBufferTicks = version == replayVersionUnbuffered ? 0 : reader.VarInt();
+
+	const uint64_t snapshotSize = reader.VarInt();
+	const uint8_t* snapshotBytes = reader.Bytes(snapshotSize);
+	if (!reader.IsOk())
+		return false;
+
+	const uint64_t recordsCount = reader.VarInt();
+	if (!reader.IsOk() || recordsCount > reader.Remaining())
+		return false;
+		// every record takes two bytes at least
+
+	std::vector<Record> newRecords;
+	newRecords.reserve(static_cast<size_t>(recordsCount));
+
+	uint64_t tick = 0;
+	for (uint64_t i = 0; i < recordsCount; ++i) {
+		tick += reader.VarInt();
+		const uint8_t type = reader.U8();
+		if (type >= static_cast<uint8_t>(InputType::UNDEFINED))
+			return false;
+
+		newRecords.push_back({tick, static_cast<InputType>(type)});
+	}
+
+	if (!reader.IsOk())
+		return false;
+
+	seed = newSeed;
+	length = newLength;
+	inputBufferTicks = newInputBufferTicks;
+	snapshot.assign(reinterpret_cast<const char*>(snapshotBytes), static_cast<size_t>(snapshotSize));
+	startTick = 0;
+	records = std::move(newRecords);
+	return true;
+}
+
+void InputReplay::Start(YetrixSimulation& simulation) {
+
+	simulation.ResetGame(log.GetSeed());
+	simulation.SetInputBufferTicks(log.GetInputBufferTicks());
+
+	const auto& snapshot = log.GetSnapshot();
+	const auto* snapshotBytes = reinterpret_cast<const uint8_t*>(snapshot.data());
+
+	if (YetrixSimulation::IsBinarySave(snapshotBytes, snapshot.size()))
+		simulation.LoadBinary(snapshotBytes, snapshot.size());
+	else if (!snapshot.empty())
+		simulation.Load(json::parse(snapshot));
+
+	startTick = simulation.GetTick();
+	nextRecord = 0;
+}
+
+void InputReplay::Feed(YetrixSimulation& simulation) {
+
+	const uint64_t tick = GetTicksPlayed(simulation);
+	const auto& records = log.GetRecords();
+
+	while (nextRecord < records.size() && records[nextRecord].tick <= tick) {
+		simulation.ApplyInput(records[nextRecord].type);
+		++nextRecord;
+	}
+}
+
+bool InputReplay::IsFinished(const YetrixSimulation& simulation) const {
+
+	return GetTicksPlayed(simulation) >= log.GetLength();
+}
+
+uint64_t InputReplay::GetTicksPlayed(const YetrixSimulation& simulation) const {
+
+	return simulation.GetTick() - startTick;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BoardGeometry.h"
+
+template <typename Board> class BasicYetrixSimulation;
+typedef BasicYetrixSimulation<ClassicBoard> YetrixSimulation;
+
+enum class InputType : uint8_t {
+	LEFT,
+	RIGHT,
+	ROTATE,
+	DROP,
+	DOWN,
+	UNDEFINED
+};
+
+// What became of one tagged input, see YetrixSimulation::ApplyInput.
+struct InputOutcome {
+	InputType type = InputType::UNDEFINED;
+	uint32_t tag = 0;
+
+	uint64_t arrivalTick = 0;
+	uint64_t handledTick = 0;
+
+	// false when it waited longer than the input buffer window, the move or turn didn't fit, or the game ended
+	// before it could be used
+	bool applied = false;
+
+	// from the press to the handling, filled in by InputPipeline::Measure
+	float latencySeconds = 0.f;
+};
+
+// Player input of one session, each with the simulation tick it arrived at, plus the seed and the saved game
+// (binary or legacy JSON, as read) the session started from, and the input buffer window it was played with.
+// That is enough to re-run the session exactly.
+class InputLog {
+public:
+	struct Record {
+		uint64_t tick = 0;
+		InputType type = InputType::UNDEFINED;
+	};
+
+	void Start(uint64_t theSeed, const std::string& theSnapshot, uint64_t theStartTick, uint64_t theInputBufferTicks = 0);
+	void Add(uint64_t tick, InputType type);
+	void Finish(uint64_t tick);
+
+	uint64_t GetSeed() const {return seed;}
+	const std::string& GetSnapshot() const {return snapshot;}
+	uint64_t GetInputBufferTicks() const {return inputBufferTicks;}
+	const std::vector<Record>& GetRecords() const {return records;}
+
+	// ticks from the start to the end of the recording
+	uint64_t GetLength() const {return length;}
+
+	// header, snapshot, then per record a LEB128 tick delta and a type byte
+	std::vector<uint8_t> Serialize() const;
+	bool Deserialize(const uint8_t* data, size_t size);
+
+private:
+	uint64_t seed = 0;
+	std::string snapshot;
+	uint64_t startTick = 0;
+	uint64_t length = 0;
+	uint64_t inputBufferTicks = 0;
+
+	std::vector<Record> records;
+};
+
+// Feeds a recorded log back into a simulation at the recorded ticks.
+class InputReplay {
+public:
+	explicit InputReplay(const InputLog& theLog) : log(theLog) {}
+
+	// resets the simulation to the state and the input buffer window the recording started with
+	void Start(YetrixSimulation& simulation);
+
+	// applies the inputs due before the next simulation tick
+	void Feed(YetrixSimulation& simulation);
+
+	bool IsFinished(const YetrixSimulation& simulation) const;
+	uint64_t GetTicksPlayed(const YetrixSimulation& simulation) const;
+
+private:
+	InputLog log;
+	size_t nextRecord = 0;
+	uint64_t startTick = 0;
+};
\ No newline at end of file
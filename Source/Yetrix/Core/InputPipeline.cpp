@@ -0,0 +1,53 @@
+#include "InputPipeline.h"
+
+#include <algorithm>
+
+#include "YetrixSimulation.h"
+
+InputPipeline::Press InputPipeline::Capture(const InputType type) {
+
+	Press press;
+	press.type = type;
+	press.tag = nextTag++;
+	press.time = Clock::now();
+
+	// 0 means untagged to the simulation
+	if (nextTag == 0)
+		nextTag = 1;
+
+	return press;
+}
+
+void InputPipeline::Add(const Press& press) {
+	queued.push_back(press);
+}
+
+size_t InputPipeline::Feed(YetrixSimulation& simulation, const Clock::time_point tickTime) {
+
+	size_t count = 0;
+	while (!queued.empty() && queued.front().time <= tickTime) {
+
+		// kept before it is applied, a drop is reported back from inside ApplyInput
+		const Press press = queued.front();
+		queued.pop_front();
+		fed.push_back(press);
+
+		simulation.ApplyInput(press.type, press.tag);
+		++count;
+	}
+
+	return count;
+}
+
+bool InputPipeline::Measure(InputOutcome& outcome) {
+
+	const auto found = std::find_if(fed.begin(), fed.end(), [&outcome](const Press& press) { return press.tag == outcome.tag; });
+	if (found == fed.end())
+		return false;
+
+	const std::chrono::duration<float> latency = Clock::now() - found->time;
+	outcome.latencySeconds = latency.count();
+
+	fed.erase(found);
+	return true;
+}
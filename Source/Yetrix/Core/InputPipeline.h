@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "InputLog.h"
+
+// Player presses on their way into the simulation. Each one is stamped when it is made and held until the tick
+// whose time slot it fell into, so a frame that runs several ticks spreads its presses over them instead of
+// piling them onto the first. Once the simulation reports a press handled, Measure tells how long that took.
+// Single-threaded, SimulationThread keeps one on its own thread and feeds it through its input queue.
+class InputPipeline {
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Press {
+		InputType type = InputType::UNDEFINED;
+		uint32_t tag = 0;
+		Clock::time_point time;
+	};
+
+	// stamps and tags a press made right now, tags count up from 1 and come back through OnInputHandled
+	Press Capture(InputType type);
+
+	// queues a press, here or in the pipeline on the simulation's thread; in the order they were made
+	void Add(const Press& press);
+
+	// applies the presses made by the time the coming tick stands for, returns how many
+	size_t Feed(YetrixSimulation& simulation, Clock::time_point tickTime);
+
+	// fills in the latency up to now, false for a tag this pipeline didn't feed
+	bool Measure(InputOutcome& outcome);
+
+	size_t GetQueuedCount() const {return queued.size();}
+
+private:
+	std::deque<Press> queued;
+
+	// fed to the simulation, waiting to be reported
+	std::vector<Press> fed;
+
+	uint32_t nextTag = 1;
+};
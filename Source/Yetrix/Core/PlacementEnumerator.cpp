@@ -0,0 +1,111 @@
+#include "PlacementEnumerator.h"
+#include <algorithm>
+#include "FigureTables.h"
+
+template <typename Board>
+typename BasicPlacementEnumerator<Board>::Rows BasicPlacementEnumerator<Board>::GetFrozenRows(const BasicBlockScene<Board>& scene) {
+
+	Rows rows;
+	for (int y = 0; y < Board::gridHeight; ++y)
+		rows[y] = scene.GetFrozenRow(y);
+
+	return rows;
+}
+
+template <typename Board>
+void BasicPlacementEnumerator<Board>::Enumerate(const Rows& rows, const Figure::FigType type, const Figure::AngleCW orientation, const Vec2D& pivot, std::vector<Placement>& placements) {
+
+	if (!FigureTables::HasType(type))
+		return;
+
+	// landed cells already reported, as shape plus corner
+	struct LandedKey {
+		FigureTables::ShapeMask cellMask;
+		Vec2D leftBottom;
+
+		bool operator==(const LandedKey& second) const {
+			return cellMask == second.cellMask && leftBottom == second.leftBottom;
+		}
+	};
+
+	std::array<LandedKey, FigureTables::orientationsCount * Board::width> landed;
+	size_t landedCount = 0;
+
+	for (int turn = 0; turn < FigureTables::orientationsCount; ++turn) {
+
+		const auto turned = FigureTables::Turn(orientation, static_cast<Figure::AngleCW>(turn));
+		const auto& shape = FigureTables::Get(type, turned);
+
+		Vec2D origin;
+		bool fits = false;
+
+		for (const auto& kick : FigureTables::kicks) {
+
+			origin = pivot + kick;
+			fits = FigureTables::Fits<Board>(rows, shape, origin);
+
+			// the figure is already in place, kicks only apply to turns
+			if (fits || turn == 0)
+				break;
+		}
+
+		if (!fits)
+			continue;
+
+		int minX = origin.x;
+		while (FigureTables::Fits<Board>(rows, shape, {minX - 1, origin.y}))
+			--minX;
+
+		int maxX = origin.x;
+		while (FigureTables::Fits<Board>(rows, shape, {maxX + 1, origin.y}))
+			++maxX;
+
+		for (int x = minX; x <= maxX; ++x) {
+
+			int y = origin.y;
+			while (FigureTables::Fits<Board>(rows, shape, {x, y - 1}))
+				--y;
+
+			const Vec2D landedPivot = {x, y};
+			const Vec2D leftBottom = landedPivot + shape.leftBottom;
+
+			const LandedKey key = {shape.cellMask, leftBottom};
+			const auto landedEnd = landed.begin() + landedCount;
+			if (std::find(landed.begin(), landedEnd, key) != landedEnd)
+				continue;
+
+			landed[landedCount++] = key;
+
+			Placement placement;
+			placement.orientation = turned;
+			placement.pivot = landedPivot;
+
+			for (size_t i = 0; i < shape.cells.size(); ++i)
+				placement.positions[i] = landedPivot + shape.cells[i];
+
+			placements.push_back(placement);
+		}
+	}
+}
+
+template <typename Board>
+std::vector<Placement> BasicPlacementEnumerator<Board>::Enumerate(const BasicBlockScene<Board>& scene, const Figure& figure) {
+
+	const auto& blockIDs = figure.GetBlockIDs();
+	if (blockIDs.size() != figureBlockCount)
+		return {};
+
+	const auto pivotBlock = scene.GetBlock(blockIDs[0]);
+	if (!pivotBlock)
+		return {};
+
+	std::vector<Placement> placements;
+	placements.reserve(FigureTables::orientationsCount * Board::width);
+	Enumerate(GetFrozenRows(scene), figure.GetType(), figure.GetOrientation(), pivotBlock->GetPosition(), placements);
+
+	return placements;
+}
+
+template class BasicPlacementEnumerator<ClassicBoard>;
+template class BasicPlacementEnumerator<WideBoard>;
+template class BasicPlacementEnumerator<HugeBoard>;
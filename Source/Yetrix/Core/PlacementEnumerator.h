@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "BlockScene.h"
+
+// final resting place of a figure, positions are in the figure's block order
+struct Placement {
+	typedef std::array<Vec2D, figureBlockCount> Positions;
+
+	Figure::AngleCW orientation = Figure::AngleCW::R0;
+	Vec2D pivot;
+	Positions positions;
+};
+
+// Lists where a figure can end up: turned in place (with the FigureTables kicks), shifted sideways
+// at its current height and dropped down. Collisions are tested against frozen row bitmasks only,
+// orientations landing on the same cells (BOX, LONG, guns) are reported once.
+// Compiled for the BoardGeometry presets, see the instantiations at the end of PlacementEnumerator.cpp.
+template <typename Board> class BasicPlacementEnumerator {
+public:
+	typedef typename Board::RowMask RowMask;
+	typedef typename Board::Rows Rows;
+
+	static Rows GetFrozenRows(const BasicBlockScene<Board>& scene);
+
+	// appends to placements, so a caller can reuse one buffer; pivot is the position of the figure's first block
+	static void Enumerate(const Rows& rows, Figure::FigType type, Figure::AngleCW orientation, const Vec2D& pivot, std::vector<Placement>& placements);
+
+	// empty if the figure doesn't have all of its blocks
+	static std::vector<Placement> Enumerate(const BasicBlockScene<Board>& scene, const Figure& figure);
+};
+
+extern template class BasicPlacementEnumerator<ClassicBoard>;
+extern template class BasicPlacementEnumerator<WideBoard>;
+extern template class BasicPlacementEnumerator<HugeBoard>;
+
+typedef BasicPlacementEnumerator<ClassicBoard> PlacementEnumerator;
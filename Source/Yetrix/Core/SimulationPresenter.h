@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include "InputLog.h"
+#include "Utils.h"
+
+class GameBlock;
+class Figure;
+
+// The simulation reports everything visible through this interface; the engine side (actors, sounds, UI) implements it.
+// All calls come from the simulation tick, defaults do nothing so headless runs can pass the base class.
+class SimulationPresenter {
+public:
+	virtual ~SimulationPresenter() {}
+
+	virtual void OnBlockAdded(const GameBlock& block) {}
+
+	// logical position changed, the view either snaps (animDuration == 0) or moves there over animDuration
+	virtual void OnBlockMoved(const GameBlock& block, float animDuration) {}
+
+	virtual void OnBlockFrozen(const GameBlock& block) {}
+	virtual void OnBlockDestroyStarted(const GameBlock& block) {}
+	virtual void OnBlockRemoved(IDType blockID) {}
+
+	// block is about to hit the ground after a quick drop
+	virtual void OnBlockLanding(IDType blockID, float afterSeconds) {}
+
+	virtual void OnFigureMoved(const Figure& figure, const Vec2D& direction) {}
+
+	// blocks already have their rotated logical positions, given in the figure's block order; the rotation is shown in stages
+	virtual void OnFigureRotateStarted(const Figure& figure, const std::vector<Vec2D>& positions) {}
+	virtual void OnFigureRotateMove(const Figure& figure) {}
+	virtual void OnFigureRotateAssemble(const Figure& figure) {}
+
+	virtual void OnQuickDrop() {}
+	virtual void OnSoftDrop() {}
+
+	virtual void OnLinesDestroyed(const std::set<int>& lines) {}
+
+	// falling blocks move from their logical positions to fallingPositions, progress 0..1
+	virtual void OnDestroyProgress(const std::map<IDType, Vec2D>& fallingPositions, float progress) {}
+
+	virtual void OnScoreChanged(int score, int hiScore) {}
+	virtual void OnScoreMilestone() {}
+	virtual void OnConditionScoreChanged(int conditionScore, int worstConditionScore) {}
+	virtual void OnSunlightChanged(float angle) {}
+
+	virtual void OnGameOver() {}
+
+	// good moment to persist the game, e.g. after lines were destroyed
+	virtual void OnSaveRequested() {}
+
+	// a tagged input was used or let go, untagged ones aren't reported
+	virtual void OnInputHandled(const InputOutcome& outcome) {}
+
+	// shows nothing, used until a real presenter is set and for headless runs
+	static SimulationPresenter& Headless() {
+		static SimulationPresenter headless;
+		return headless;
+	}
+};
\ No newline at end of file
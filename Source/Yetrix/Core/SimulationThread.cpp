@@ -0,0 +1,305 @@
+#include "SimulationThread.h"
+
+#include <chrono>
+
+static GameBlock MakeBlock(const GameBlock::BlockInfo& info) {
+
+	GameBlock block;
+	block.Init(info);
+	return block;
+}
+
+void PresenterCall::Replay(SimulationPresenter& target) const {
+
+	Figure figure(figureType, figureID);
+	figure.SetBlockIDs(blockIDs);
+	figure.SetOrientation(orientation);
+
+	switch (type) {
+		case Type::BLOCK_ADDED: target.OnBlockAdded(MakeBlock(block)); break;
+		case Type::BLOCK_MOVED: target.OnBlockMoved(MakeBlock(block), value); break;
+		case Type::BLOCK_FROZEN: target.OnBlockFrozen(MakeBlock(block)); break;
+		case Type::BLOCK_DESTROY_STARTED: target.OnBlockDestroyStarted(MakeBlock(block)); break;
+		case Type::BLOCK_REMOVED: target.OnBlockRemoved(block.id); break;
+		case Type::BLOCK_LANDING: target.OnBlockLanding(block.id, value); break;
+		case Type::FIGURE_MOVED: target.OnFigureMoved(figure, direction); break;
+		case Type::FIGURE_ROTATE_STARTED: target.OnFigureRotateStarted(figure, positions); break;
+		case Type::FIGURE_ROTATE_MOVE: target.OnFigureRotateMove(figure); break;
+		case Type::FIGURE_ROTATE_ASSEMBLE: target.OnFigureRotateAssemble(figure); break;
+		case Type::QUICK_DROP: target.OnQuickDrop(); break;
+		case Type::SOFT_DROP: target.OnSoftDrop(); break;
+		case Type::LINES_DESTROYED: target.OnLinesDestroyed(lines); break;
+		case Type::DESTROY_PROGRESS: target.OnDestroyProgress(fallingPositions, value); break;
+		case Type::SCORE_CHANGED: target.OnScoreChanged(first, second); break;
+		case Type::SCORE_MILESTONE: target.OnScoreMilestone(); break;
+		case Type::CONDITION_SCORE_CHANGED: target.OnConditionScoreChanged(first, second); break;
+		case Type::SUNLIGHT_CHANGED: target.OnSunlightChanged(value); break;
+		case Type::GAME_OVER: target.OnGameOver(); break;
+		case Type::SAVE_REQUESTED: target.OnSaveRequested(); break;
+		case Type::INPUT_HANDLED: target.OnInputHandled(input); break;
+	}
+}
+
+// Turns every call into a PresenterCall for the game thread. Runs on the simulation thread, one call buffer
+// is reused, its containers keep their capacity between calls.
+class SimulationThread::QueuedPresenter : public SimulationPresenter {
+public:
+	explicit QueuedPresenter(SimulationThread& theOwner) : owner(theOwner) {
+	}
+
+	void OnBlockAdded(const GameBlock& block) override {Block(PresenterCall::Type::BLOCK_ADDED, block);}
+
+	void OnBlockMoved(const GameBlock& block, const float animDuration) override {
+		call.value = animDuration;
+		Block(PresenterCall::Type::BLOCK_MOVED, block);
+	}
+
+	void OnBlockFrozen(const GameBlock& block) override {Block(PresenterCall::Type::BLOCK_FROZEN, block);}
+	void OnBlockDestroyStarted(const GameBlock& block) override {Block(PresenterCall::Type::BLOCK_DESTROY_STARTED, block);}
+
+	void OnBlockRemoved(const IDType blockID) override {
+		call.block.id = blockID;
+		Send(PresenterCall::Type::BLOCK_REMOVED);
+	}
+
+	void OnBlockLanding(const IDType blockID, const float afterSeconds) override {
+		call.block.id = blockID;
+		call.value = afterSeconds;
+		Send(PresenterCall::Type::BLOCK_LANDING);
+	}
+
+	void OnFigureMoved(const Figure& figure, const Vec2D& direction) override {
+		call.direction = direction;
+		FigureCall(PresenterCall::Type::FIGURE_MOVED, figure);
+	}
+
+	void OnFigureRotateStarted(const Figure& figure, const std::vector<Vec2D>& positions) override {
+		call.positions = positions;
+		FigureCall(PresenterCall::Type::FIGURE_ROTATE_STARTED, figure);
+	}
+
+	void OnFigureRotateMove(const Figure& figure) override {FigureCall(PresenterCall::Type::FIGURE_ROTATE_MOVE, figure);}
+	void OnFigureRotateAssemble(const Figure& figure) override {FigureCall(PresenterCall::Type::FIGURE_ROTATE_ASSEMBLE, figure);}
+
+	void OnQuickDrop() override {Send(PresenterCall::Type::QUICK_DROP);}
+	void OnSoftDrop() override {Send(PresenterCall::Type::SOFT_DROP);}
+
+	void OnLinesDestroyed(const std::set<int>& lines) override {
+		call.lines = lines;
+		Send(PresenterCall::Type::LINES_DESTROYED);
+	}
+
+	void OnDestroyProgress(const std::map<IDType, Vec2D>& fallingPositions, const float progress) override {
+		call.fallingPositions = fallingPositions;
+		call.value = progress;
+		Send(PresenterCall::Type::DESTROY_PROGRESS);
+	}
+
+	void OnScoreChanged(const int score, const int hiScore) override {
+		call.first = score;
+		call.second = hiScore;
+		Send(PresenterCall::Type::SCORE_CHANGED);
+	}
+
+	void OnScoreMilestone() override {Send(PresenterCall::Type::SCORE_MILESTONE);}
+
+	void OnConditionScoreChanged(const int conditionScore, const int worstConditionScore) override {
+		call.first = conditionScore;
+		call.second = worstConditionScore;
+		Send(PresenterCall::Type::CONDITION_SCORE_CHANGED);
+	}
+
+	void OnSunlightChanged(const float angle) override {
+		call.value = angle;
+		Send(PresenterCall::Type::SUNLIGHT_CHANGED);
+	}
+
+	void OnGameOver() override {Send(PresenterCall::Type::GAME_OVER);}
+
+	// the game thread can't ask for a save later, the simulation will have moved on by then
+	void OnSaveRequested() override {
+		call.save = owner.simulation.SaveBinary();
+		Send(PresenterCall::Type::SAVE_REQUESTED);
+	}
+
+	void OnInputHandled(const InputOutcome& outcome) override {
+		call.input = outcome;
+		owner.pipeline.Measure(call.input);
+		Send(PresenterCall::Type::INPUT_HANDLED);
+	}
+
+private:
+	void Block(const PresenterCall::Type type, const GameBlock& block) {
+		call.block = block.GetBlockInfo();
+		Send(type);
+	}
+
+	void FigureCall(const PresenterCall::Type type, const Figure& figure) {
+		call.figureType = figure.GetType();
+		call.figureID = figure.GetID();
+		call.orientation = figure.GetOrientation();
+		call.blockIDs = figure.GetBlockIDs();
+		Send(type);
+	}
+
+	void Send(const PresenterCall::Type type) {
+		call.type = type;
+		owner.Enqueue(call);
+
+		// only the calls that fill them copy them along
+		call.blockIDs.clear();
+		call.positions.clear();
+		call.lines.clear();
+		call.fallingPositions.clear();
+		call.save.clear();
+	}
+
+	SimulationThread& owner;
+	PresenterCall call;
+};
+
+SimulationThread::SimulationThread(YetrixSimulation& theSimulation) : SimulationThread(theSimulation, Settings()) {
+}
+
+SimulationThread::SimulationThread(YetrixSimulation& theSimulation, const Settings& theSettings)
+	: simulation(theSimulation), settings(theSettings), queuedPresenter(std::make_unique<QueuedPresenter>(*this)) {
+}
+
+SimulationThread::~SimulationThread() {
+	Stop();
+}
+
+void SimulationThread::Start() {
+
+	if (thread.joinable())
+		return;
+
+	simulation.SetPresenter(queuedPresenter.get());
+	PublishSnapshot();
+
+	stopRequested.store(false, std::memory_order_release);
+	running.store(true, std::memory_order_release);
+	thread = std::thread([this]() { Run(); });
+}
+
+void SimulationThread::Stop() {
+
+	if (!thread.joinable())
+		return;
+
+	stopRequested.store(true, std::memory_order_release);
+	thread.join();
+
+	simulation.SetPresenter(nullptr);
+}
+
+bool SimulationThread::PushInput(const InputPipeline::Press& press) {
+
+	if (inputs.TryPush(press))
+		return true;
+
+	++droppedInputs;
+	return false;
+}
+
+size_t SimulationThread::DispatchCalls(SimulationPresenter& target) {
+
+	size_t count = 0;
+	while (calls.TryPop(dispatchedCall)) {
+
+		if (dispatchedCall.type == PresenterCall::Type::SAVE_REQUESTED)
+			dispatchedSave.swap(dispatchedCall.save);
+
+		dispatchedCall.Replay(target);
+		++count;
+	}
+
+	return count;
+}
+
+const SimulationSnapshot& SimulationThread::GetSnapshot() {
+
+	snapshots.Update();
+	return snapshots.GetReadBuffer();
+}
+
+void SimulationThread::Enqueue(PresenterCall& call) {
+
+	bool stalled = false;
+	while (!calls.TryPush(call)) {
+
+		if (stopRequested.load(std::memory_order_acquire))
+			return;
+
+		stalled = true;
+		std::this_thread::yield();
+	}
+
+	if (stalled)
+		presenterStalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SimulationThread::Run() {
+
+	typedef InputPipeline::Clock Clock;
+
+	const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(settings.stepSeconds));
+	auto nextTick = Clock::now();
+
+	while (!stopRequested.load(std::memory_order_acquire)) {
+
+		// presses made after the time this tick stands for wait for the next one
+		Step(step.count() > 0 ? nextTick : Clock::now());
+
+		if (settings.maxTicks > 0 && ++ticksRun >= settings.maxTicks)
+			break;
+
+		if (step.count() <= 0)
+			continue;
+
+		nextTick += step;
+
+		// after a stall the lost time is let go, as the frame loop does past maxCatchUpSteps
+		const auto now = Clock::now();
+		if (now - nextTick > step * maxCatchUpSteps)
+			nextTick = now;
+
+		std::this_thread::sleep_until(nextTick);
+	}
+
+	running.store(false, std::memory_order_release);
+}
+
+void SimulationThread::Step(const InputPipeline::Clock::time_point tickTime) {
+
+	InputPipeline::Press press;
+	while (inputs.TryPop(press))
+		pipeline.Add(press);
+
+	pipeline.Feed(simulation, tickTime);
+
+	if (tickHook)
+		tickHook(simulation);
+
+	simulation.Tick(simulationUpdateInterval);
+	PublishSnapshot();
+}
+
+void SimulationThread::PublishSnapshot() {
+
+	auto& snapshot = snapshots.GetWriteBuffer();
+
+	snapshot.tick = simulation.GetTick();
+	snapshot.score = simulation.GetScore();
+	snapshot.hiScore = simulation.GetHiScore();
+	snapshot.conditionScore = simulation.GetConditionScore();
+	snapshot.worstConditionScore = simulation.GetWorstConditionScore();
+	snapshot.sunlightAngle = simulation.GetSunlightAngle();
+	snapshot.dropState = simulation.GetDropState();
+
+	snapshot.blocks.clear();
+	for (const auto& [blockID, blockPtr] : simulation.GetBlockScene()->GetBlocks())
+		snapshot.blocks.push_back(blockPtr->GetBlockInfo());
+
+	snapshots.Publish();
+}
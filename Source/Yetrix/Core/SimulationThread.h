@@ -0,0 +1,169 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "InputPipeline.h"
+#include "SimulationPresenter.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+#include "YetrixSimulation.h"
+
+// What the game thread knows of the board without asking the simulation, published after every tick.
+struct SimulationSnapshot {
+	uint64_t tick = 0;
+
+	int score = 0;
+	int hiScore = 0;
+	int conditionScore = 0;
+	int worstConditionScore = 0;
+	float sunlightAngle = 0.f;
+	YetrixSimulation::DropState dropState = YetrixSimulation::DropState::STILL;
+
+	// live blocks, dying ones are left out
+	std::vector<GameBlock::BlockInfo> blocks;
+};
+
+// One SimulationPresenter call with copies of its arguments, so it can be replayed on another thread.
+struct PresenterCall {
+	enum class Type : uint8_t {
+		BLOCK_ADDED,
+		BLOCK_MOVED,
+		BLOCK_FROZEN,
+		BLOCK_DESTROY_STARTED,
+		BLOCK_REMOVED,
+		BLOCK_LANDING,
+		FIGURE_MOVED,
+		FIGURE_ROTATE_STARTED,
+		FIGURE_ROTATE_MOVE,
+		FIGURE_ROTATE_ASSEMBLE,
+		QUICK_DROP,
+		SOFT_DROP,
+		LINES_DESTROYED,
+		DESTROY_PROGRESS,
+		SCORE_CHANGED,
+		SCORE_MILESTONE,
+		CONDITION_SCORE_CHANGED,
+		SUNLIGHT_CHANGED,
+		GAME_OVER,
+		SAVE_REQUESTED,
+		INPUT_HANDLED
+	};
+
+	Type type = Type::SCORE_MILESTONE;
+
+	// block calls, and the block ID of removing and landing
+	GameBlock::BlockInfo block;
+
+	// figure calls
+	Figure::FigType figureType = Figure::FigType::UNDEFINED;
+	IDType figureID;
+	Figure::AngleCW orientation = Figure::AngleCW::R0;
+	std::vector<IDType> blockIDs;
+	std::vector<Vec2D> positions;
+	Vec2D direction;
+
+	// animation duration, landing delay, destroy progress or sunlight angle
+	float value = 0.f;
+
+	// score and hiscore, or condition score and the worst one
+	int first = 0;
+	int second = 0;
+
+	std::set<int> lines;
+	std::map<IDType, Vec2D> fallingPositions;
+
+	// binary save taken right when the simulation asked for it
+	std::vector<uint8_t> save;
+
+	// measured on the simulation thread, when it was handled rather than when the call gets dispatched
+	InputOutcome input;
+
+	void Replay(SimulationPresenter& target) const;
+};
+
+// Runs a YetrixSimulation on a thread of its own at a fixed step. Input comes in through a lock-free queue and is
+// applied at the start of the first tick due after the press, presenter calls go out through another one and the
+// board state through a triple buffer. Nothing else may touch the simulation between Start and Stop.
+class SimulationThread {
+public:
+	// runs on the simulation thread before every tick, after the queued input, e.g. to drive an autoplayer
+	typedef std::function<void(YetrixSimulation&)> TickHook;
+
+	struct Settings {
+		// wall time per tick, 0 runs as fast as the presenter calls are taken
+		float stepSeconds = simulationUpdateInterval;
+
+		// stops by itself after this many ticks, 0 runs until Stop
+		uint64_t maxTicks = 0;
+	};
+
+	explicit SimulationThread(YetrixSimulation& theSimulation);
+	SimulationThread(YetrixSimulation& theSimulation, const Settings& theSettings);
+	~SimulationThread();
+
+	SimulationThread(const SimulationThread&) = delete;
+	SimulationThread& operator=(const SimulationThread&) = delete;
+
+	// before Start
+	void SetTickHook(TickHook hook) {tickHook = std::move(hook);}
+
+	// the simulation reports to a queue from here on; after Stop its presenter is up to the caller again
+	void Start();
+	void Stop();
+	bool IsRunning() const {return running.load(std::memory_order_acquire);}
+
+	// game thread side
+
+	// false when the queue is full, the input is lost then
+	bool PushInput(const InputPipeline::Press& press);
+
+	// replays the calls made since the last dispatch, returns how many there were; still works after Stop
+	size_t DispatchCalls(SimulationPresenter& target);
+
+	// the latest published state
+	const SimulationSnapshot& GetSnapshot();
+
+	// taken with the last dispatched OnSaveRequested
+	const std::vector<uint8_t>& GetDispatchedSave() const {return dispatchedSave;}
+
+	unsigned GetDroppedInputs() const {return droppedInputs;}
+	unsigned GetPresenterStalls() const {return presenterStalls.load(std::memory_order_relaxed);}
+
+private:
+	class QueuedPresenter;
+
+	void Run();
+	void Step(InputPipeline::Clock::time_point tickTime);
+	void PublishSnapshot();
+
+	// waits while the game thread is behind, gives up when stopping
+	void Enqueue(PresenterCall& call);
+
+	YetrixSimulation& simulation;
+	Settings settings;
+	TickHook tickHook;
+
+	std::unique_ptr<QueuedPresenter> queuedPresenter;
+
+	SpscQueue<InputPipeline::Press, 8> inputs;
+	InputPipeline pipeline;
+	SpscQueue<PresenterCall, 10> calls;
+	TripleBuffer<SimulationSnapshot> snapshots;
+
+	std::thread thread;
+	std::atomic<bool> stopRequested {false};
+	std::atomic<bool> running {false};
+	uint64_t ticksRun = 0;
+
+	std::vector<uint8_t> dispatchedSave;
+	PresenterCall dispatchedCall;
+
+	unsigned droppedInputs = 0;
+	std::atomic<unsigned> presenterStalls {0};
+};
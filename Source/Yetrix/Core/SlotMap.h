@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Utils.h"
+
+// Dense storage addressed by generational handles: lookups are array indexing,
+// a freed slot bumps its generation so stale handles stop resolving.
+template <typename ValueType> class SlotMap {
+
+	struct Slot {
+		ValueType value {};
+		uint32_t generation = 0;
+		bool used = false;
+	};
+
+	template <bool IsConst> class IteratorBase {
+	public:
+		typedef std::conditional_t<IsConst, const std::vector<Slot>, std::vector<Slot>> SlotVector;
+		typedef std::conditional_t<IsConst, const ValueType&, ValueType&> ValueRef;
+
+		IteratorBase(SlotVector& theSlots, const size_t theIndex) : slots(&theSlots), index(theIndex) {
+			SkipUnused();
+		}
+
+		std::pair<IDType, ValueRef> operator*() const {
+			auto& slot = (*slots)[index];
+			return {IDType(static_cast<uint32_t>(index), slot.generation), slot.value};
+		}
+
+		IteratorBase& operator++() {
+			++index;
+			SkipUnused();
+			return *this;
+		}
+
+		bool operator==(const IteratorBase& second) const { return index == second.index; }
+		bool operator!=(const IteratorBase& second) const { return index != second.index; }
+
+	private:
+		void SkipUnused() {
+			while (index < slots->size() && !(*slots)[index].used)
+				++index;
+		}
+
+		SlotVector* slots = nullptr;
+		size_t index = 0;
+	};
+
+public:
+	typedef IteratorBase<false> iterator;
+	typedef IteratorBase<true> const_iterator;
+
+	IDType insert(ValueType value) {
+
+		uint32_t index;
+		if (freeSlots.empty()) {
+			index = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+		else {
+			index = freeSlots.back();
+			freeSlots.pop_back();
+		}
+
+		auto& slot = slots[index];
+		slot.value = std::move(value);
+		slot.used = true;
+		++usedCount;
+
+		return {index, slot.generation};
+	}
+
+	bool erase(const IDType id) {
+
+		if (!count(id))
+			return false;
+
+		auto& slot = slots[id.index];
+		slot.value = ValueType {};
+		slot.used = false;
+		++slot.generation;
+
+		freeSlots.push_back(id.index);
+		--usedCount;
+		return true;
+	}
+
+	size_t count(const IDType id) const {
+		const bool found = id.index < slots.size() && slots[id.index].used && slots[id.index].generation == id.generation;
+		return found ? 1 : 0;
+	}
+
+	// nullptr if the handle is stale or was never issued
+	ValueType* find(const IDType id) { return count(id) ? &slots[id.index].value : nullptr; }
+	const ValueType* find(const IDType id) const { return count(id) ? &slots[id.index].value : nullptr; }
+
+	ValueType& at(const IDType id) {
+		assert(count(id) && "SlotMap::at error, invalid handle");
+		return slots[id.index].value;
+	}
+
+	const ValueType& at(const IDType id) const {
+		assert(count(id) && "SlotMap::at error, invalid handle");
+		return slots[id.index].value;
+	}
+
+	size_t size() const { return usedCount; }
+	bool empty() const { return usedCount == 0; }
+
+	// keeps generations, so handles issued before clear() stay invalid
+	void clear() {
+
+		freeSlots.clear();
+		for (size_t index = slots.size(); index > 0; --index) {
+
+			auto& slot = slots[index - 1];
+			if (slot.used) {
+				slot.value = ValueType {};
+				slot.used = false;
+				++slot.generation;
+			}
+
+			freeSlots.push_back(static_cast<uint32_t>(index - 1));
+		}
+
+		usedCount = 0;
+	}
+
+	iterator begin() { return iterator(slots, 0); }
+	iterator end() { return iterator(slots, slots.size()); }
+	const_iterator begin() const { return const_iterator(slots, 0); }
+	const_iterator end() const { return const_iterator(slots, slots.size()); }
+
+private:
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+	size_t usedCount = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue between exactly one producer thread and one consumer thread. Each side
+// writes only its own index and keeps a copy of the other one, so most calls touch no shared line.
+template <typename ValueType, size_t CapacityLog2> class SpscQueue {
+public:
+	static constexpr size_t capacity = size_t(1) << CapacityLog2;
+
+	SpscQueue() : slots(capacity) {
+	}
+
+	// producer only, false when full; copied into the slot, which keeps the capacity of whatever it held before
+	bool TryPush(const ValueType& value) {
+
+		const size_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (tail - headCopy == capacity) {
+			headCopy = headIndex.load(std::memory_order_acquire);
+			if (tail - headCopy == capacity)
+				return false;
+		}
+
+		slots[tail & mask] = value;
+		tailIndex.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// consumer only, false when empty; swapped out, the slot gets the previous value back for reuse
+	bool TryPop(ValueType& value) {
+
+		const size_t head = headIndex.load(std::memory_order_relaxed);
+		if (head == tailCopy) {
+			tailCopy = tailIndex.load(std::memory_order_acquire);
+			if (head == tailCopy)
+				return false;
+		}
+
+		using std::swap;
+		swap(value, slots[head & mask]);
+		headIndex.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// either side, already stale when it returns
+	size_t GetSizeApprox() const {
+		return tailIndex.load(std::memory_order_acquire) - headIndex.load(std::memory_order_acquire);
+	}
+
+private:
+	static constexpr size_t mask = capacity - 1;
+	static constexpr size_t cacheLineSize = 64;
+
+	// consumer side
+	alignas(cacheLineSize) std::atomic<size_t> headIndex {0};
+	size_t tailCopy = 0;
+
+	// producer side
+	alignas(cacheLineSize) std::atomic<size_t> tailIndex {0};
+	size_t headCopy = 0;
+
+	alignas(cacheLineSize) std::vector<ValueType> slots;
+};
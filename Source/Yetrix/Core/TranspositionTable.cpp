@@ -0,0 +1,58 @@
+#include "TranspositionTable.h"
+#include <cassert>
+
+TranspositionTable::TranspositionTable(const unsigned sizeLog2) : slots(new Slot[size_t(1) << sizeLog2]), mask((1ull << sizeLog2) - 1) {
+}
+
+bool TranspositionTable::Find(const uint64_t key, uint64_t& value) const {
+
+	lookups.fetch_add(1, std::memory_order_relaxed);
+
+	const Slot& slot = slots[key & mask];
+	const uint64_t data = slot.data.load(std::memory_order_relaxed);
+	const uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+	if (!(data & usedBit) || (check ^ data) != key)
+		return false;
+
+	hits.fetch_add(1, std::memory_order_relaxed);
+	value = data & maxValue;
+	return true;
+}
+
+void TranspositionTable::Store(const uint64_t key, const uint64_t value) {
+
+	assert(value <= maxValue);
+	stores.fetch_add(1, std::memory_order_relaxed);
+
+	Slot& slot = slots[key & mask];
+	const uint64_t data = value | usedBit;
+
+	slot.data.store(data, std::memory_order_relaxed);
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::Clear() {
+
+	for (size_t i = 0; i < GetSize(); ++i) {
+		slots[i].data.store(0, std::memory_order_relaxed);
+		slots[i].check.store(0, std::memory_order_relaxed);
+	}
+}
+
+TranspositionTable::Stats TranspositionTable::GetStats() const {
+
+	Stats stats;
+	stats.lookups = lookups.load(std::memory_order_relaxed);
+	stats.hits = hits.load(std::memory_order_relaxed);
+	stats.stores = stores.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void TranspositionTable::ResetStats() {
+
+	lookups.store(0, std::memory_order_relaxed);
+	hits.store(0, std::memory_order_relaxed);
+	stores.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size cache from a 64-bit board hash to a value of up to 63 bits, shared between threads without locks.
+// A slot keeps the value and the key XORed with it: a torn write shows up as a key mismatch and reads as a miss.
+// Keys landing on the same slot replace each other, so the table never grows.
+class TranspositionTable {
+public:
+	static constexpr uint64_t maxValue = (1ull << 63) - 1;
+
+	explicit TranspositionTable(unsigned sizeLog2);
+
+	bool Find(uint64_t key, uint64_t& value) const;
+	void Store(uint64_t key, uint64_t value);
+
+	void Clear();
+
+	struct Stats {
+		uint64_t lookups = 0;
+		uint64_t hits = 0;
+		uint64_t stores = 0;
+
+		double GetHitRate() const { return lookups ? static_cast<double>(hits) / lookups : 0.0; }
+	};
+
+	Stats GetStats() const;
+	void ResetStats();
+
+	size_t GetSize() const { return static_cast<size_t>(mask) + 1; }
+
+private:
+	struct Slot {
+		std::atomic<uint64_t> check {0};
+		std::atomic<uint64_t> data {0};
+	};
+
+	// set on every stored value, so an untouched slot never matches
+	static constexpr uint64_t usedBit = 1ull << 63;
+
+	std::unique_ptr<Slot[]> slots;
+	uint64_t mask = 0;
+
+	mutable std::atomic<uint64_t> lookups {0};
+	mutable std::atomic<uint64_t> hits {0};
+	std::atomic<uint64_t> stores {0};
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Latest value hand-off from one writer thread to one reader thread. The writer fills its own buffer and
+// publishes it by swapping it with the spare one, the reader swaps the spare one in when it is newer.
+// Nobody waits: a slow reader skips the versions it didn't get to.
+template <typename ValueType> class TripleBuffer {
+public:
+	// writer only, holds whatever was published two versions ago, so fill it in full
+	ValueType& GetWriteBuffer() {return buffers[writeIndex];}
+
+	void Publish() {
+		const uint8_t previous = spare.exchange(static_cast<uint8_t>(writeIndex | freshBit), std::memory_order_acq_rel);
+		writeIndex = previous & indexMask;
+	}
+
+	// reader only, true when a newer version was taken
+	bool Update() {
+
+		if (!(spare.load(std::memory_order_relaxed) & freshBit))
+			return false;
+
+		const uint8_t previous = spare.exchange(readIndex, std::memory_order_acq_rel);
+		readIndex = previous & indexMask;
+		return true;
+	}
+
+	// reader only, stays the same until the next Update
+	const ValueType& GetReadBuffer() const {return buffers[readIndex];}
+
+private:
+	static constexpr uint8_t indexMask = 3;
+	static constexpr uint8_t freshBit = 4;
+
+	std::array<ValueType, 3> buffers;
+
+	uint8_t writeIndex = 0;
+	std::atomic<uint8_t> spare {1};
+	uint8_t readIndex = 2;
+};
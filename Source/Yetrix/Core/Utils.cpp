@@ -0,0 +1,21 @@
+#include "Utils.h"
+
+RandomStream::RandomStream(const uint64_t seed, const uint64_t streamIndex) {
+
+	// same seed with a different stream index gives an unrelated sequence
+	uint64_t mix = seed ^ (streamIndex * 0xD1B54A32D192ED03ull);
+
+	const uint64_t first = Utils::SplitMix64(mix);
+	const uint64_t second = Utils::SplitMix64(mix);
+
+	state = {
+		static_cast<uint32_t>(first),
+		static_cast<uint32_t>(first >> 32),
+		static_cast<uint32_t>(second),
+		static_cast<uint32_t>(second >> 32)
+	};
+
+	if (state[0] == 0 && state[1] == 0 && state[2] == 0 && state[3] == 0)
+		state[0] = 1;
+		// all-zero is the one state xoshiro never leaves
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <bitset>
+#include <intrin.h>
+#endif
+
+// slot index plus generation, issued by SlotMap
+struct Handle {
+
+	static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+	uint32_t index = invalidIndex;
+	uint32_t generation = 0;
+
+	constexpr Handle() {}
+	constexpr Handle(const uint32_t theIndex, const uint32_t theGeneration) : index(theIndex), generation(theGeneration) {}
+
+	bool IsValid() const { return index != invalidIndex; }
+
+	bool operator==(const Handle& second) const {
+		return index == second.index && generation == second.generation;
+	}
+
+	bool operator!=(const Handle& second) const {
+		return !(*this == second);
+	}
+
+	bool operator<(const Handle& second) const {
+		if (index != second.index)
+			return index < second.index;
+
+		return generation < second.generation;
+	}
+
+	std::string ToString() const {
+		return std::to_string(index) + ":" + std::to_string(generation);
+	}
+};
+
+typedef Handle IDType;
+constexpr float timeNotDefined = std::numeric_limits<float>::min();
+
+template <typename ValueType> struct Vec2DBase {
+
+	static constexpr ValueType notDefined = std::numeric_limits<ValueType>::min();
+
+	ValueType x = notDefined;
+	ValueType y = notDefined;
+
+	constexpr Vec2DBase(){}
+	constexpr Vec2DBase(const ValueType xx, const ValueType yy) : x(xx), y(yy){}
+
+	constexpr bool operator==(const Vec2DBase& second) const {
+		return x == second.x && y == second.y;
+	}
+
+	constexpr bool operator!=(const Vec2DBase& second) const {
+		return !(*this == second);
+	}
+
+	constexpr bool operator< (const Vec2DBase& second) const {
+		if (y != second.y)
+			return y < second.y;
+
+		return x < second.x;
+	}
+};
+
+template <typename ValueType> constexpr Vec2DBase<ValueType> operator+(const Vec2DBase<ValueType>& first, const Vec2DBase<ValueType>& second) {
+
+	return {first.x + second.x, first.y + second.y};
+}
+
+template <typename ValueType> constexpr Vec2DBase<ValueType> operator-(const Vec2DBase<ValueType>& first, const Vec2DBase<ValueType>& second) {
+
+	return {first.x - second.x, first.y - second.y};
+}
+
+typedef Vec2DBase<int> Vec2D;
+
+// xoshiro128** seeded through splitmix64. Streams are independent: gameplay and cosmetics draw from
+// different ones, so effects and sounds never shift the piece sequence. Satisfies UniformRandomBitGenerator.
+class RandomStream {
+public:
+	typedef uint32_t result_type;
+	typedef std::array<uint32_t, 4> StateType;
+
+	explicit RandomStream(uint64_t seed = 0, uint64_t streamIndex = 0);
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()() { return Next(); }
+
+	uint32_t Next() {
+		const uint32_t result = RotateLeft(state[1] * 5, 7) * 9;
+		const uint32_t shifted = state[1] << 9;
+
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= shifted;
+		state[3] = RotateLeft(state[3], 11);
+
+		return result;
+	}
+
+	uint64_t Next64() {
+		const uint64_t high = Next();
+		return (high << 32) | Next();
+	}
+
+	// uniform in [0, bound), multiply-shift with rejection (Lemire), no modulo bias
+	uint32_t NextBelow(const uint32_t bound) {
+		uint64_t product = static_cast<uint64_t>(Next()) * bound;
+		uint32_t low = static_cast<uint32_t>(product);
+
+		if (low < bound) {
+			const uint32_t threshold = (0u - bound) % bound;
+			while (low < threshold) {
+				product = static_cast<uint64_t>(Next()) * bound;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+
+		return static_cast<uint32_t>(product >> 32);
+	}
+
+	// uniform in [0, 1)
+	float Next01() { return (Next() >> 8) * (1.f / 16777216.f); }
+	float NextRange(const float minValue, const float maxValue) { return minValue + Next01() * (maxValue - minValue); }
+	bool NextYesNo() { return (Next() >> 31) != 0; }
+
+	// independent child stream, advances this one
+	RandomStream Split() { return RandomStream(Next64()); }
+
+	const StateType& GetState() const { return state; }
+	void SetState(const StateType& theState) { state = theState; }
+
+private:
+	static uint32_t RotateLeft(const uint32_t value, const int bits) { return (value << bits) | (value >> (32 - bits)); }
+
+	StateType state {};
+};
+
+namespace Utils {
+	// advances x, used to seed generators and to build constant random tables
+	constexpr uint64_t SplitMix64(uint64_t& x) {
+
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// any unsigned type up to 64 bits, row masks come in 16, 32 and 64 bits; 0 for 0
+	template <typename T> int CountTrailingZeros(const T value) {
+		static_assert(std::is_unsigned<T>::value && sizeof(T) <= sizeof(uint64_t));
+		if (!value)
+			return 0;
+#if defined(_MSC_VER)
+		unsigned long index = 0;
+		_BitScanForward64(&index, static_cast<uint64_t>(value));
+		return static_cast<int>(index);
+#else
+		return __builtin_ctzll(static_cast<unsigned long long>(value));
+#endif
+	}
+
+	// MSVC's bitset count picks popcnt when the CPU has it, __popcnt alone would fault on one that doesn't
+	template <typename T> int CountSetBits(const T value) {
+		static_assert(std::is_unsigned<T>::value && sizeof(T) <= sizeof(uint64_t));
+#if defined(_MSC_VER)
+		return static_cast<int>(std::bitset<64>(static_cast<uint64_t>(value)).count());
+#else
+		return __builtin_popcountll(static_cast<unsigned long long>(value));
+#endif
+	}
+
+	constexpr IDType emptyID {};
+}
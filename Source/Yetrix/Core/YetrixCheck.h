@@ -0,0 +1,15 @@
+#pragma once
+
+// Scene consistency checks. The engine build keeps checkf for them, as before the simulation moved out of the
+// engine, so they stay on in Development builds and go away in Shipping. The standalone build uses assert, so
+// they go away with NDEBUG there, e.g. in a Release build of the bench. Define YETRIX_CHECKF before the Core
+// headers to route them elsewhere.
+#ifndef YETRIX_CHECKF
+#if defined(UE_BUILD_SHIPPING)
+#include "Misc/AssertionMacros.h"
+#define YETRIX_CHECKF(expression, message) checkf(expression, TEXT(message))
+#else
+#include <cassert>
+#define YETRIX_CHECKF(expression, message) assert((expression) && message)
+#endif
+#endif
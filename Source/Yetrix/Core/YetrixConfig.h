@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+constexpr float blockSize = 100.f;
+constexpr float destroyActorAfter = 3.f;
+constexpr float simulationUpdateInterval = 0.01f;
+
+// simulation steps one frame may run after a hitch, older backlog is dropped
+constexpr int maxCatchUpSteps = 25;
+
+// seconds a move or rotation may wait through dropping and destroying before it is let go
+constexpr float inputBufferWindow = 0.25f;
+
+constexpr float speedUpCoeff = 0.99f;
+
+constexpr float destroyYShift = 300.f;
+
+// the game's board, ClassicBoard in BoardGeometry.h; spawn point and grid size follow from it
+constexpr int checkHeight = 20;
+
+constexpr float assembleDuration = 0.2f;
+
+constexpr int rightBorderX = 11;
+
+// enough block actors for a full playfield, spawned up front
+constexpr unsigned blockActorPoolPrewarmSize = (rightBorderX - 1) * checkHeight;
+
+// keeps a settled block as a full actor while its smoke puff plays
+constexpr float smokePuffHoldDuration = 1.f;
+
+constexpr float lightZRotationInit = -10.f;
+constexpr float lightZRotationAddPerExplosion = 15.f;
+
+constexpr float sunMoveDuration = 1.f;
+
+constexpr unsigned minFigures = 1;
+
+// every figure type is a tetromino
+constexpr int figureBlockCount = 4;
+
+// stream indices for RandomStream, one seed feeds all of them
+constexpr uint64_t gameplayRandomStream = 0;
+constexpr uint64_t cosmeticRandomStream = 1;
+
+static const std::array<int, 4> scorePerCombo = {10, 25, 40, 60};
+
+// weights of BlockScene::CalculateSceneConditionScore, the autoplayer rates its boards the same way
+constexpr float conditionMaxHeightCoeff = 1.f;
+constexpr float conditionMinHeightCoeff = 0.5f;
+constexpr float conditionHolesCoeff = 5.f;
+constexpr float conditionBlocksCoeff = 0.2f;
+
+// the autoplayer's transposition table holds 2^n entries of 16 bytes
+constexpr unsigned autoplayerRatingCacheSizeLog2 = 16;
+
+constexpr float stillStateInitialDuration = 0.5f;
+constexpr float dropStateInitialDuration = 0.1f;
+constexpr float destroyingStateInitialDuration = 0.5f;
+
+constexpr float rotateStateInitialDuration = 0.4f;
+constexpr float rotate1StageDuration = 0.1f;
+constexpr float rotate2StageDuration = 0.2f;
+constexpr float rotate3StageDuration = 0.1f;
+
+static_assert(rotateStateInitialDuration - (rotate1StageDuration + rotate2StageDuration + rotate3StageDuration) <  0.001f);
+static_assert(rotateStateInitialDuration - (rotate1StageDuration + rotate2StageDuration + rotate3StageDuration) > -0.001f);
+
+constexpr float moveLeftRightAnimDuration = 0.1f;
+
+constexpr int scoreYeahInterval = 100;
\ No newline at end of file
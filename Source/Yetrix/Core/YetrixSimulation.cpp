@@ -0,0 +1,765 @@
+#include "YetrixSimulation.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include "ByteStream.h"
+#include "FigureTables.h"
+#include "YetrixCheck.h"
+
+#include "3rdparty/nlohmann/json.hpp"
+
+static constexpr char saveMagic[4] = {'Y', 'S', 'A', 'V'};
+static constexpr uint8_t saveVersion = 1;
+
+// where a new figure's blocks fly in from, one per block: the first half from the left, the rest from the right
+typedef std::array<Vec2D, figureBlockCount> AssembleOrigins;
+
+static constexpr AssembleOrigins MakeAssembleOrigins() {
+
+	constexpr int step = 10;
+	constexpr int leftCount = figureBlockCount / 2;
+
+	AssembleOrigins origins = {};
+	for (int i = 0; i < figureBlockCount; ++i)
+		origins[i] = i < leftCount ? Vec2D{-25 + step * i, 25} : Vec2D{25 + step * (i - leftCount), 25};
+	return origins;
+}
+
+static constexpr AssembleOrigins assembleOrigins = MakeAssembleOrigins();
+static_assert(std::tuple_size<AssembleOrigins>::value == figureBlockCount);
+
+template <typename Board>
+BasicYetrixSimulation<Board>::BasicYetrixSimulation(const uint64_t seed) {
+	static_assert(FigureTables::FitsSpawnArea<Board>(), "new figures don't fit the board");
+	ResetGame(seed);
+}
+
+template <typename Board>
+BasicYetrixSimulation<Board>::~BasicYetrixSimulation() {
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::SetPresenter(SimulationPresenter* thePresenter) {
+
+	presenter = thePresenter ? thePresenter : &SimulationPresenter::Headless();
+	statePtr->blockScenePtr->SetPresenter(presenter);
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::HandleDestruction()
+{
+	const auto& linesToDestruct = CheckDestruction();
+	if (linesToDestruct.empty())
+		return false;
+	
+	statePtr->fallingPositions = statePtr->blockScenePtr->GetFallingPositions(linesToDestruct);
+	statePtr->currDropState = DropState::DESTROYING;
+	StartDropStateTimer(statePtr->destroyStateDuration);
+	statePtr->destroyStartTick = statePtr->events.GetNow();
+
+	const auto howManyLines = linesToDestruct.size();
+	const int prevHundreds = statePtr->score / 100;
+
+	//assert(howManyLines <= 4);
+	AddScore(scorePerCombo[howManyLines - 1]);
+
+	const int nowHundreds = statePtr->score / 100;
+
+	if (nowHundreds > prevHundreds)
+		presenter->OnScoreMilestone();
+
+	statePtr->lightAngleStart = statePtr->lightAngleCurrent;
+	statePtr->lightAngleEnd += lightZRotationAddPerExplosion;
+	statePtr->sunMoveFinishTimer = sunMoveDuration;
+
+	return true;
+}
+
+template <typename Board>
+std::map<int, std::vector<IDType> > BasicYetrixSimulation<Board>::GetBlocksSortedFromLower(const Figure::Ptr figure) const
+{
+	std::map<int, std::vector<IDType> > sortedResult;
+	const std::vector<IDType>& blockIDs = figure->GetBlockIDs();
+
+	for (const auto blockID : blockIDs) {
+		const auto block = statePtr->blockScenePtr->GetBlock(blockID);
+		const auto logicalPos = block->GetPosition();
+
+		sortedResult[logicalPos.y].push_back(blockID);
+	}
+
+	return sortedResult;
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::CheckConditionChange()
+{
+	const auto newConditionScore = GetBlockScene()->CalculateSceneConditionScore();
+	if (newConditionScore == statePtr->conditionScore)
+		return false;
+
+	statePtr->conditionScore = newConditionScore;
+	if (statePtr->conditionScore > worstConditionScore)
+		worstConditionScore = statePtr->conditionScore;
+
+	presenter->OnConditionScoreChanged(statePtr->conditionScore, worstConditionScore);
+	return true;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::OnStartDropping() {
+
+	statePtr->blockScenePtr->DeconstructFigures();
+	const bool destructionStarted = HandleDestruction();
+
+	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
+	const auto& figures = statePtr->blockScenePtr->GetFigures();
+	for (const auto& [figID, figPtr] : figures) {
+		
+		unsigned maxHeight = 0;
+		const bool canDrop = statePtr->blockScenePtr->CheckFigureCanMove(figPtr, {0, -1}, maxHeight);
+		if (!canDrop)
+			continue;
+
+		const bool isLowestOne = figID == lowestFigID;
+		const bool canQuickDrop = isLowestOne && statePtr->quickDropRequested; 
+		const int heightToDrop = canQuickDrop ? maxHeight : 1;
+		
+		const auto& blocksSortedByY = GetBlocksSortedFromLower(figPtr);
+		const auto& blockIDs = figPtr->GetBlockIDs();
+
+		int yInd = 0;
+		size_t blockInd = 0;
+
+		for (const auto& [y, blocks] : blocksSortedByY)
+		{
+			for (const auto blockID : blocks) {
+				const auto block = statePtr->blockScenePtr->GetBlock(blockID);
+				const auto logicalPos = block->GetPosition();
+				auto dropLogicalPos = logicalPos;
+				dropLogicalPos.y -= heightToDrop;
+
+				auto fallDuration = statePtr->dropStateDuration;
+				constexpr float lowerFallDurationMultiplier = 0.25f;
+				const bool isLower = (yInd == 0);
+				
+				if (statePtr->quickDropRequested)
+				{
+					// lowest left-est block will have max speed, toppest rightest block - lowest speed (fall last)
+					fallDuration = lowerFallDurationMultiplier + (statePtr->dropStateDuration - statePtr->dropStateDuration * lowerFallDurationMultiplier) * (static_cast<float>(blockInd) / blockIDs.size());
+
+					// apply smoke effect if needed
+					if (isLower)
+						presenter->OnBlockLanding(blockID, fallDuration);
+				}
+				statePtr->blockScenePtr->MoveBlock(block, dropLogicalPos, fallDuration);
+				blockInd++;
+			}
+
+			yInd++;
+		}
+	}
+
+	if (statePtr->quickDropRequested)
+	{
+		statePtr->quickDropRequested = false;
+		presenter->OnQuickDrop();
+	}
+		
+	const bool figureAdded = CheckAddFigures();
+
+	if (figureAdded && !destructionStarted)
+		CheckConditionChange();
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::UpdateSpeed()
+{
+	const float speedMultiplier = std::pow(speedUpCoeff, statePtr->score / 10.f);
+
+	statePtr->stillStateDuration = stillStateInitialDuration * speedMultiplier;
+	statePtr->dropStateDuration = dropStateInitialDuration * speedMultiplier;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::AddScore(const int score) {
+
+	statePtr->score += score;
+	presenter->OnScoreChanged(statePtr->score, hiScore);
+	UpdateSpeed();
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::UpdateSunMove(const float dt) {
+
+	if (statePtr->sunMoveFinishTimer <= 0.f) {
+		statePtr->sunMoveFinishTimer = 0.f;
+		return;
+	}
+
+	statePtr->sunMoveFinishTimer -= dt;
+
+	if (statePtr->sunMoveFinishTimer <= 0.f) {
+		statePtr->sunMoveFinishTimer = 0.f;
+	}
+
+	const float progress = 1.f - statePtr->sunMoveFinishTimer / sunMoveDuration;
+	const float currAngle = statePtr->lightAngleStart + (statePtr->lightAngleEnd - statePtr->lightAngleStart) * progress;
+
+	UpdateSunlight(currAngle);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::UpdateSunlight(const float angle) {
+
+	statePtr->lightAngleCurrent = angle;
+	presenter->OnSunlightChanged(angle);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::GameOver()
+{
+	if (statePtr->score > hiScore)
+		hiScore = statePtr->score;
+
+	// next game continues the gameplay stream, so a whole session follows from the first seed
+	ResetGame(statePtr->pieceRnd.Next64());
+	presenter->OnSaveRequested();
+	presenter->OnGameOver();
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::CheckAddFigures() {
+
+	if (statePtr->blockScenePtr->GetFigures().size() >= minFigures)
+		return false;
+
+	const auto figureAdded = statePtr->blockScenePtr->CreateRandomFigureAt({Board::spawnX, Board::spawnY}, statePtr->pieceRnd);
+	if (!figureAdded) {
+		GameOver();
+		return false;
+	}
+
+	// apply assemble animation
+	const auto& blockIDs = figureAdded->GetBlockIDs();
+	YETRIX_CHECKF(blockIDs.size() == assembleOrigins.size(), "YetrixSimulation::CheckAddFigures error, figure block count differs from figureBlockCount");
+
+	size_t asseblePosInd = 0;
+	for (const auto blockID : blockIDs)
+	{
+		const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockID);
+
+		const auto blockPosNeeded = blockPtr->GetPosition();
+		const Vec2D assembleFromPos = assembleOrigins[asseblePosInd];
+
+		statePtr->blockScenePtr->MoveBlock(blockPtr, assembleFromPos);
+		statePtr->blockScenePtr->MoveBlock(blockPtr, blockPosNeeded, assembleDuration);
+
+		asseblePosInd++;
+	}
+
+	return true;
+}
+
+template <typename Board>
+std::vector<Figure::FigType> BasicYetrixSimulation<Board>::PeekFigureTypes(const size_t count) const {
+
+	RandomStream rnd = statePtr->pieceRnd;
+
+	std::vector<Figure::FigType> types;
+	types.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+		types.push_back(Scene::DrawFigureType(rnd));
+
+	return types;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::RecordInput(const InputType type) {
+
+	if (inputLog)
+		inputLog->Add(tick, type);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::ApplyInput(const InputType type, const uint32_t tag) {
+
+	if (type == InputType::UNDEFINED)
+		return;
+
+	RecordInput(type);
+	const PendingInput input = {type, tag, tick};
+
+	switch (type) {
+		case InputType::LEFT: statePtr->leftPending.push_back(input); break;
+		case InputType::RIGHT: statePtr->rightPending.push_back(input); break;
+		case InputType::ROTATE: statePtr->rotatePending.push_back(input); break;
+
+		case InputType::DROP:
+			statePtr->quickDropRequested = true;
+			StartDropStateTimer(0.f);
+			ReportInput(input, true);
+			break;
+
+		case InputType::DOWN: {
+			const bool still = statePtr->currDropState == DropState::STILL;
+			if (still)
+			{
+				presenter->OnSoftDrop();
+				StartDropStateTimer(0.f);
+			}
+			ReportInput(input, still);
+			break;
+		}
+
+		default: break;
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Left() {
+	ApplyInput(InputType::LEFT);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Right() {
+	ApplyInput(InputType::RIGHT);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Rotate() {
+	ApplyInput(InputType::ROTATE);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Drop() {
+	ApplyInput(InputType::DROP);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Down() {
+	ApplyInput(InputType::DOWN);
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::TakePendingInput(PendingInputs& pending, PendingInput& input) {
+
+	while (!pending.empty()) {
+
+		input = pending.front();
+		pending.pop_front();
+
+		const bool expired = inputBufferTicks > 0 && tick - input.arrivalTick > inputBufferTicks;
+		if (!expired)
+			return true;
+
+		ReportInput(input, false);
+	}
+
+	return false;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::DiscardPendingInput() {
+
+	for (PendingInputs* pending : {&statePtr->leftPending, &statePtr->rightPending, &statePtr->rotatePending}) {
+		for (const auto& input : *pending)
+			ReportInput(input, false);
+
+		pending->clear();
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::ReportInput(const PendingInput& input, const bool applied) {
+
+	if (input.tag == 0)
+		return;
+
+	InputOutcome outcome;
+	outcome.type = input.type;
+	outcome.tag = input.tag;
+	outcome.arrivalTick = input.arrivalTick;
+	outcome.handledTick = tick;
+	outcome.applied = applied;
+	presenter->OnInputHandled(outcome);
+}
+
+template <typename Board>
+std::set<int> BasicYetrixSimulation<Board>::CheckDestruction(const Scene& theBlockScene)
+{
+	return theBlockScene.GetFullRows();
+}
+
+template <typename Board>
+std::set<int> BasicYetrixSimulation<Board>::CheckDestruction() {
+
+	const std::set<int>& linesToBoom = CheckDestruction(*statePtr->blockScenePtr);
+	
+	if (!linesToBoom.empty())
+		presenter->OnLinesDestroyed(linesToBoom);
+
+	for (const int y : linesToBoom) {
+
+		for (int x = 1; x < Board::rightBorderX; ++x)
+		{
+			Vec2D blockPos(x, y);
+			const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockPos, true);
+			statePtr->blockScenePtr->StartDestroy(blockPtr);
+		}
+	}
+
+	return linesToBoom;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::FinalizeLogicalDestroy() {
+
+	for (const auto& fallingBlockInfo : statePtr->fallingPositions) {
+
+		const auto blockPtr = statePtr->blockScenePtr->GetBlock(fallingBlockInfo.first);
+		statePtr->blockScenePtr->MoveBlock(blockPtr, fallingBlockInfo.second);
+	}
+	
+	statePtr->fallingPositions.clear();
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::OnStopDestroying() {
+	presenter->OnDestroyProgress(statePtr->fallingPositions, 1.f);
+	FinalizeLogicalDestroy();
+	CheckConditionChange();
+
+	presenter->OnSaveRequested();
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::OnStopDropping() {
+}
+
+template <typename Board>
+json BasicYetrixSimulation<Board>::Save() const
+{
+	json doc;
+	doc["blockScene"] = statePtr->blockScenePtr->Save();
+	doc["score"] = statePtr->score;
+	doc["hiscore"] = hiScore;
+	doc["worstConditionScore"] = worstConditionScore;
+	doc["seed"] = statePtr->seed;
+	doc["rngState"] = statePtr->pieceRnd.GetState();
+
+	return doc;
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::Load(const json& doc)
+{
+	statePtr->blockScenePtr->Load(doc["blockScene"]);
+	statePtr->score = doc["score"].get<int>();
+	hiScore = doc["hiscore"].get<int>();
+	worstConditionScore = doc["worstConditionScore"].get<int>();
+
+	// older saves have no seed, the current stream just goes on
+	if (doc.contains("seed") && doc.contains("rngState")) {
+		statePtr->seed = doc["seed"].get<uint64_t>();
+		statePtr->pieceRnd.SetState(doc["rngState"].get<RandomStream::StateType>());
+	}
+
+	OnLoaded();
+	return true;
+}
+
+template <typename Board>
+std::vector<uint8_t> BasicYetrixSimulation<Board>::SaveBinary() const
+{
+	std::vector<uint8_t> out;
+	out.reserve(128);
+
+	ByteWriter writer(out);
+	writer.Bytes(saveMagic, sizeof(saveMagic));
+	writer.U8(saveVersion);
+
+	writer.SignedVarInt(statePtr->score);
+	writer.SignedVarInt(hiScore);
+	writer.SignedVarInt(worstConditionScore);
+
+	writer.U64(statePtr->seed);
+	for (const uint32_t word : statePtr->pieceRnd.GetState())
+		writer.U32(word);
+
+	statePtr->blockScenePtr->SaveBinary(writer);
+	return out;
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::IsBinarySave(const uint8_t* data, const size_t size)
+{
+	return size >= sizeof(saveMagic) && std::memcmp(data, saveMagic, sizeof(saveMagic)) == 0;
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::LoadBinary(const uint8_t* data, const size_t size)
+{
+	ByteReader reader(data, size);
+	if (!reader.Expect(saveMagic, sizeof(saveMagic)) || reader.U8() != saveVersion)
+		return false;
+
+	const int newScore = static_cast<int>(reader.SignedVarInt());
+	const int newHiScore = static_cast<int>(reader.SignedVarInt());
+	const int newWorstConditionScore = static_cast<int>(reader.SignedVarInt());
+
+	const uint64_t newSeed = reader.U64();
+	RandomStream::StateType rngState;
+	for (uint32_t& word : rngState)
+		word = reader.U32();
+
+	if (!reader.IsOk() || !statePtr->blockScenePtr->LoadBinary(reader))
+		return false;
+
+	statePtr->score = newScore;
+	hiScore = newHiScore;
+	worstConditionScore = newWorstConditionScore;
+	statePtr->seed = newSeed;
+	statePtr->pieceRnd.SetState(rngState);
+
+	OnLoaded();
+	return true;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::OnLoaded()
+{
+	presenter->OnScoreChanged(statePtr->score, hiScore);
+	CheckConditionChange();
+	UpdateSpeed();
+}
+
+template <typename Board>
+uint64_t BasicYetrixSimulation<Board>::CountdownTicks(const float duration, const float dt) {
+
+	assert(dt > 0.f);
+	if (dt <= 0.f)
+		return 1;
+
+	// float steps, as the per-tick timers had, so recorded replays change state at the same ticks
+	float timer = duration;
+	uint64_t ticks = 0;
+	do {
+		timer -= dt;
+		++ticks;
+	} while (timer >= 0.f);
+
+	return ticks;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::StartDropStateTimer(const float duration) {
+
+	auto& events = statePtr->events;
+	events.Cancel(SimulationEvent::DROP_STATE_TIMEOUT);
+	events.ScheduleAfter(CountdownTicks(duration, stepDt), SimulationEvent::DROP_STATE_TIMEOUT);
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::ScheduleRotateStages() {
+
+	auto& events = statePtr->events;
+	events.Cancel(SimulationEvent::ROTATE_MOVE);
+	events.Cancel(SimulationEvent::ROTATE_ASSEMBLE);
+
+	// one stage per tick at most, none once the rotation times out
+	float timer = rotateStateInitialDuration;
+	bool moveScheduled = false;
+
+	for (uint64_t ticks = 1;; ++ticks) {
+
+		timer -= stepDt;
+		if (timer < 0.f)
+			return;
+
+		const float elapsed = rotateStateInitialDuration - timer;
+		if (elapsed < rotate1StageDuration)
+			continue;
+			// visual 'break' in progress
+
+		if (!moveScheduled && elapsed < rotate1StageDuration + rotate2StageDuration) {
+			events.ScheduleAfter(ticks, SimulationEvent::ROTATE_MOVE);
+			moveScheduled = true;
+		}
+		else if (moveScheduled && elapsed > rotate1StageDuration + rotate2StageDuration) {
+			events.ScheduleAfter(ticks, SimulationEvent::ROTATE_ASSEMBLE);
+			return;
+		}
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::HandleEvent(const SimulationEvent event) {
+
+	if (event == SimulationEvent::DROP_STATE_TIMEOUT) {
+		ChangeDropState();
+		return;
+	}
+
+	assert(statePtr->currDropState == DropState::ROTATING);
+
+	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
+	const auto& figure = statePtr->blockScenePtr->GetFigures().at(lowestFigID);
+
+	if (event == SimulationEvent::ROTATE_MOVE) {
+		// moving to rotated positions, but still in modified 'depth'-planes
+		presenter->OnFigureRotateMove(*figure);
+		statePtr->currRotateState = RotateSubState::MOVE_2;
+	}
+	else {
+		presenter->OnFigureRotateAssemble(*figure);
+		statePtr->currRotateState = RotateSubState::ASSEMBLE_3;
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::ChangeDropState() {
+
+	if (statePtr->currDropState == DropState::ROTATING) {
+		statePtr->currDropState = DropState::STILL;
+		statePtr->events.Cancel(SimulationEvent::ROTATE_MOVE);
+		statePtr->events.Cancel(SimulationEvent::ROTATE_ASSEMBLE);
+	}
+
+	if (statePtr->currDropState == DropState::STILL) {
+		statePtr->currDropState = DropState::DROPPING;
+		StartDropStateTimer(statePtr->dropStateDuration);
+		OnStartDropping();
+	}
+	else if (statePtr->currDropState == DropState::DROPPING) {
+		statePtr->currDropState = DropState::STILL;
+
+		// should drop quickly, don't wait in STILL state
+		StartDropStateTimer(statePtr->quickDropRequested ? 0.f : statePtr->stillStateDuration);
+
+		OnStopDropping();
+	}
+	else if (statePtr->currDropState == DropState::DESTROYING) {
+		statePtr->currDropState = DropState::STILL;
+		StartDropStateTimer(statePtr->stillStateDuration);
+		OnStopDestroying();
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::ResetGame(const uint64_t seed) {
+
+	if (statePtr)
+	{
+		// the figure they were meant for is gone
+		DiscardPendingInput();
+		statePtr->blockScenePtr->Clear();
+	}
+
+	statePtr = std::make_unique<State>(seed);
+	statePtr->blockScenePtr->SetPresenter(presenter);
+
+	// a new game starts dropping on the next tick
+	StartDropStateTimer(0.f);
+
+	worstConditionScore = 0;
+	presenter->OnScoreChanged(statePtr->score, hiScore);
+	UpdateSunlight(lightZRotationInit);
+}
+
+template <typename Board>
+bool BasicYetrixSimulation<Board>::TryRotate()
+{
+	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
+
+	if (lowestFigID == Utils::emptyID)
+		return false;
+		// nothing to rotate
+
+	const auto& figure = statePtr->blockScenePtr->GetFigures().at(lowestFigID);
+	const bool canRotate = statePtr->blockScenePtr->RotateFigure(figure);
+	if (!canRotate)
+		return false;
+
+	statePtr->currDropState = DropState::ROTATING;
+	statePtr->currRotateState = RotateSubState::BREAK_1;
+	StartDropStateTimer(rotateStateInitialDuration);
+	ScheduleRotateStages();
+
+	std::vector<Vec2D> positions;
+	positions.reserve(figure->GetBlockIDs().size());
+	for (const auto blockID : figure->GetBlockIDs())
+		positions.push_back(statePtr->blockScenePtr->GetBlock(blockID)->GetPosition());
+
+	presenter->OnFigureRotateStarted(*figure, positions);
+	return true;
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::HandlePlayerPendingInput()
+{
+	PendingInput input;
+	while (TakePendingInput(statePtr->leftPending, input))
+	{
+		const bool moveOk = statePtr->blockScenePtr->TryMoveBlock({-1, 0});
+		ReportInput(input, moveOk);
+		if (!moveOk)
+			break;
+	}
+	while (TakePendingInput(statePtr->rightPending, input)) {
+
+		const bool moveOk = statePtr->blockScenePtr->TryMoveBlock({1, 0});
+		ReportInput(input, moveOk);
+		if (!moveOk)
+			break;
+	}
+
+	while (TakePendingInput(statePtr->rotatePending, input))
+	{
+		const bool rotated = TryRotate();
+		ReportInput(input, rotated);
+		if (!rotated) 
+			break;
+	}
+}
+
+template <typename Board>
+void BasicYetrixSimulation<Board>::Tick(const float dt) {
+
+	stepDt = dt;
+	UpdateSunMove(dt);
+
+	statePtr->events.Advance();
+
+	// a game over replaces the state and its events on the way, so it is looked up every time
+	SimulationEvent event;
+	while (statePtr->events.PopDue(event))
+		HandleEvent(event);
+
+	if (statePtr->currDropState == DropState::DESTROYING) {
+
+		const float elapsed = static_cast<float>(statePtr->events.GetNow() - statePtr->destroyStartTick) * dt;
+		const float dropProgress = std::min(elapsed / statePtr->destroyStateDuration, 1.f);
+		presenter->OnDestroyProgress(statePtr->fallingPositions, dropProgress);
+	}
+	else if (statePtr->currDropState == DropState::DROPPING) {
+
+		// no action required
+
+	} else {
+
+		//STILL or ROTATING	
+		HandlePlayerPendingInput();
+	}
+
+	statePtr->blockScenePtr->Tick(dt);
+	++tick;
+}
+
+template class BasicYetrixSimulation<ClassicBoard>;
+template class BasicYetrixSimulation<WideBoard>;
+template class BasicYetrixSimulation<HugeBoard>;
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "BlockScene.h"
+#include "EventScheduler.h"
+#include "InputLog.h"
+#include "SimulationPresenter.h"
+#include "YetrixConfig.h"
+
+#include "3rdparty/nlohmann/json_fwd.hpp"
+
+using json = nlohmann::json;
+
+// Drop/rotate/destroy state machine and scoring, stepped with a fixed dt. State changes and rotation
+// stages are scheduled ahead in ticks, a tick with nothing due does almost nothing.
+// Knows nothing about the engine: everything visible goes through SimulationPresenter.
+// Plays on any BoardGeometry preset, see the instantiations at the end of YetrixSimulation.cpp.
+template <typename Board> class BasicYetrixSimulation {
+public:
+	typedef BasicBlockScene<Board> Scene;
+
+	enum class DropState {
+		STILL,
+		DROPPING,
+		DESTROYING,
+		ROTATING
+	};
+
+	enum class RotateSubState
+	{
+		BREAK_1,
+		MOVE_2,
+		ASSEMBLE_3,
+		STATIC
+	};
+
+	explicit BasicYetrixSimulation(uint64_t seed = 0);
+	~BasicYetrixSimulation();
+
+	void SetPresenter(SimulationPresenter* thePresenter);
+
+	// same seed and same input give the same game
+	void ResetGame(uint64_t seed);
+	void Tick(float dt);
+
+	void Left();
+	void Right();
+	void Drop();
+	void Down();
+	void Rotate();
+
+	// moves and rotations wait for the figure to be free again; a non-zero tag gets the input reported
+	// through OnInputHandled once it is used or let go
+	void ApplyInput(InputType type, uint32_t tag = 0);
+
+	// every input from here on is added to the log with the tick it arrived at, nullptr stops recording
+	void SetInputLog(InputLog* log) {inputLog = log;}
+
+	// how many ticks a move or rotation may wait through dropping and destroying, 0 waits as long as it takes;
+	// it changes the game, so a replay has to use the one it was recorded with
+	void SetInputBufferTicks(uint64_t ticks) {inputBufferTicks = ticks;}
+	uint64_t GetInputBufferTicks() const {return inputBufferTicks;}
+
+	// ticks since construction, not reset with the game
+	uint64_t GetTick() const {return tick;}
+
+	// versioned binary save, a few dozen bytes for a typical board
+	std::vector<uint8_t> SaveBinary() const;
+	bool LoadBinary(const uint8_t* data, size_t size);
+	static bool IsBinarySave(const uint8_t* data, size_t size);
+
+	// legacy JSON format, still read for old saves
+	json Save() const;
+	bool Load(const json& doc);
+
+	const Scene* GetBlockScene() const {return statePtr->blockScenePtr.get();}
+	DropState GetDropState() const {return statePtr->currDropState;}
+
+	int GetScore() const {return statePtr->score;}
+	int GetHiScore() const {return hiScore;}
+	int GetConditionScore() const {return statePtr->conditionScore;}
+	int GetWorstConditionScore() const {return worstConditionScore;}
+	float GetSunlightAngle() const {return statePtr->lightAngleCurrent;}
+	uint64_t GetSeed() const {return statePtr->seed;}
+
+	// types of the next figures to spawn, drawn from a copy of the gameplay stream
+	std::vector<Figure::FigType> PeekFigureTypes(size_t count) const;
+
+	static std::set<int> CheckDestruction(const Scene& theBlockScene);
+
+private:
+	// timeouts sort before the rotation stages due at the same tick
+	enum class SimulationEvent : uint8_t {
+		DROP_STATE_TIMEOUT,
+		ROTATE_MOVE,
+		ROTATE_ASSEMBLE
+	};
+
+	void HandleEvent(SimulationEvent event);
+	void ChangeDropState();
+	void StartDropStateTimer(float duration);
+	void ScheduleRotateStages();
+
+	// ticks until a timer of this duration, counted down by dt, goes below zero
+	static uint64_t CountdownTicks(float duration, float dt);
+
+	bool HandleDestruction();
+	std::map<int, std::vector<IDType>> GetBlocksSortedFromLower(const Figure::Ptr figurePtr) const;
+	void OnStartDropping();
+	void OnStopDropping();
+	void OnStopDestroying();
+
+	void FinalizeLogicalDestroy();
+	std::set<int> CheckDestruction();
+
+	struct PendingInput {
+		InputType type = InputType::UNDEFINED;
+		uint32_t tag = 0;
+		uint64_t arrivalTick = 0;
+	};
+
+	// oldest first
+	typedef std::deque<PendingInput> PendingInputs;
+
+	bool CheckAddFigures();
+	bool TryRotate();
+	void HandlePlayerPendingInput();
+
+	// lets go of the expired inputs on the way, false when none is left; the caller reports the one taken
+	bool TakePendingInput(PendingInputs& pending, PendingInput& input);
+	void DiscardPendingInput();
+	void ReportInput(const PendingInput& input, bool applied);
+
+	void AddScore(const int score);
+	void GameOver();
+	void UpdateSunlight(const float angle);
+	void UpdateSunMove(const float dt);
+
+	void UpdateSpeed();
+	void RecordInput(InputType type);
+	void OnLoaded();
+
+	bool CheckConditionChange();
+
+	struct State {
+
+		explicit State(const uint64_t theSeed) : seed(theSeed), pieceRnd(theSeed, gameplayRandomStream) {
+			blockScenePtr = std::make_unique<Scene>();
+		}
+
+		uint64_t seed = 0;
+		RandomStream pieceRnd;
+
+		DropState currDropState = DropState::STILL;
+		RotateSubState currRotateState = RotateSubState::STATIC;
+
+		// drop state timeout and rotation stages, in this game's ticks
+		EventScheduler<SimulationEvent> events;
+		uint64_t destroyStartTick = 0;
+
+		float stillStateDuration = stillStateInitialDuration;
+		float dropStateDuration = dropStateInitialDuration;
+		float destroyStateDuration = destroyingStateInitialDuration;
+
+		bool quickDropRequested = false;
+
+		PendingInputs leftPending;
+		PendingInputs rightPending;
+		PendingInputs rotatePending;
+
+		int score = 0;
+		int conditionScore = 0;
+
+		float lightAngleCurrent = 0.f;
+
+		float lightAngleStart = 0.f;
+		float lightAngleEnd = 0.f;
+		float sunMoveFinishTimer = 0.f;
+
+		std::map<IDType, Vec2D> fallingPositions;
+		std::unique_ptr<Scene> blockScenePtr;
+	};
+
+	std::unique_ptr<State> statePtr;
+	int hiScore = 0;
+	int worstConditionScore = 0;
+
+	SimulationPresenter* presenter = &SimulationPresenter::Headless();
+	InputLog* inputLog = nullptr;
+	uint64_t tick = 0;
+	uint64_t inputBufferTicks = 0;
+
+	// dt of the current tick, durations are converted to ticks with it
+	float stepDt = simulationUpdateInterval;
+};
+
+extern template class BasicYetrixSimulation<ClassicBoard>;
+extern template class BasicYetrixSimulation<WideBoard>;
+extern template class BasicYetrixSimulation<HugeBoard>;
+
+// the game the engine runs
+typedef BasicYetrixSimulation<ClassicBoard> YetrixSimulation;
\ No newline at end of file
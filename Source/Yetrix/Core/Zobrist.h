@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "Utils.h"
+#include "BoardGeometry.h"
+
+// Random key per grid cell and block kind, a board hashes to the XOR of the keys of its blocks.
+// Keys are fixed at compile time, so hashes are the same across runs and machines.
+namespace Zobrist {
+	template <size_t CellCount> constexpr std::array<uint64_t, CellCount * 2> MakeKeys() {
+
+		std::array<uint64_t, CellCount * 2> keys {};
+		uint64_t state = 0x59455452495821ull;
+		for (auto& key : keys)
+			key = Utils::SplitMix64(state);
+
+		return keys;
+	}
+
+	// two keys per grid cell of the board
+	template <typename Board> inline constexpr auto keys = MakeKeys<static_cast<size_t>(Board::gridWidth) * Board::gridHeight>();
+
+	template <typename Board = ClassicBoard> constexpr uint64_t GetCellKey(const int x, const int y, const bool frozen) {
+		return keys<Board>[(static_cast<size_t>(y) * Board::gridWidth + x) * 2 + (frozen ? 0 : 1)];
+	}
+
+	// frozen blocks given as row bitmasks, bit (x - 1) for column x
+	template <typename Board = ClassicBoard, typename RowsType> uint64_t HashFrozenRows(const RowsType& rows) {
+
+		uint64_t hash = 0;
+		for (int y = 0; y < static_cast<int>(rows.size()); ++y)
+			for (auto row = rows[y]; row; row &= row - 1)
+				hash ^= GetCellKey<Board>(Utils::CountTrailingZeros(row) + 1, y, true);
+
+		return hash;
+	}
+}
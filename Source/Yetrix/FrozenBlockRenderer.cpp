@@ -0,0 +1,57 @@
+#include "FrozenBlockRenderer.h"
+
+#include "Yetrix.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Frozen blocks flush"), STAT_YetrixFrozenBlocksFlush, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Frozen block instances"), STAT_YetrixFrozenBlockInstances, STATGROUP_Yetrix);
+
+FrozenBlockRenderer::FrozenBlockRenderer(AActor* owner, const UStaticMeshComponent* blockMeshComponent) {
+
+	instances = NewObject<UHierarchicalInstancedStaticMeshComponent>(owner);
+	if (!instances)
+		return;
+
+	if (blockMeshComponent)
+	{
+		instances->SetStaticMesh(blockMeshComponent->GetStaticMesh());
+		instances->SetMaterial(0, blockMeshComponent->GetMaterial(0));
+		meshTransform = blockMeshComponent->GetRelativeTransform();
+	}
+
+	instances->SetMobility(EComponentMobility::Movable);
+	instances->RegisterComponent();
+	owner->AddInstanceComponent(instances);
+}
+
+void FrozenBlockRenderer::SetInstance(const BlockView* view, const FVector& location) {
+
+	locations[view] = location;
+	dirty = true;
+}
+
+void FrozenBlockRenderer::RemoveInstance(const BlockView* view) {
+
+	if (locations.erase(view) > 0)
+		dirty = true;
+}
+
+void FrozenBlockRenderer::Flush() {
+
+	if (!dirty || !instances)
+		return;
+
+	SCOPE_CYCLE_COUNTER(STAT_YetrixFrozenBlocksFlush);
+
+	TArray<FTransform> transforms;
+	transforms.Reserve(static_cast<int32>(locations.size()));
+
+	for (const auto& [view, location] : locations)
+		transforms.Add(meshTransform * FTransform(location));
+
+	instances->ClearInstances();
+	instances->AddInstances(transforms, false, true);
+
+	SET_DWORD_STAT(STAT_YetrixFrozenBlockInstances, locations.size());
+	dirty = false;
+}
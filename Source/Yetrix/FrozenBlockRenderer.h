@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <map>
+
+class BlockView;
+class UHierarchicalInstancedStaticMeshComponent;
+class UStaticMeshComponent;
+
+// Draws settled blocks as instances of a single hierarchical instanced mesh instead of one actor per block.
+class FrozenBlockRenderer {
+public:
+	FrozenBlockRenderer(AActor* owner, const UStaticMeshComponent* blockMeshComponent);
+
+	void SetInstance(const BlockView* view, const FVector& location);
+	void RemoveInstance(const BlockView* view);
+
+	// instances are rebuilt once per frame at most, settled stacks change rarely
+	void Flush();
+
+	size_t GetInstanceCount() const {return locations.size();}
+
+private:
+	UHierarchicalInstancedStaticMeshComponent* instances = nullptr;
+	FTransform meshTransform;
+
+	std::map<const BlockView*, FVector> locations;
+	bool dirty = false;
+};
@@ -1,5 +1,6 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
+using System.IO;
 using UnrealBuildTool;
 
 public class Yetrix : ModuleRules
@@ -12,6 +13,9 @@ public class Yetrix : ModuleRules
 
 		PrivateDependencyModuleNames.AddRange(new string[] {  });
 
+		// engine-independent simulation, also built standalone through Core/CMakeLists.txt
+		PublicIncludePaths.Add(Path.Combine(ModuleDirectory, "Core"));
+
 		// Uncomment if you are using Slate UI
 		// PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
 		
@@ -2,3 +2,5 @@
 
 #include "CoreMinimal.h"
 
+// "stat Yetrix" shows simulation cost next to the scene size
+DECLARE_STATS_GROUP(TEXT("Yetrix"), STATGROUP_Yetrix, STATCAT_Advanced);
@@ -1,4 +1,5 @@
 #include "YetrixGameModeBase.h"
+#include "Yetrix.h"
 #include "YetrixPlayerController.h"
 #include "YetrixPawn.h"
 
@@ -10,11 +11,89 @@
 #include "3rdparty/nlohmann/json.hpp"
 #include "Utils.h"
 #include "YetrixSaveGame.h"
+#include "BlockBase.h"
+#include "PlacementEnumerator.h"
+
+#include "Async/ParallelFor.h"
+
+#include "Components/StaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DECLARE_CYCLE_STAT(TEXT("Simulation tick"), STAT_YetrixSimulationTick, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Scene blocks"), STAT_YetrixSceneBlocks, STATGROUP_Yetrix);
+DECLARE_CYCLE_STAT(TEXT("Save"), STAT_YetrixSave, STATGROUP_Yetrix);
+DECLARE_CYCLE_STAT(TEXT("Load"), STAT_YetrixLoad, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Save size"), STAT_YetrixSaveSize, STATGROUP_Yetrix);
+DECLARE_CYCLE_STAT(TEXT("Autoplayer"), STAT_YetrixAutoplayer, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Moving blocks"), STAT_YetrixMovingBlocks, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Settling blocks"), STAT_YetrixSettlingBlocks, STATGROUP_Yetrix);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Coalesced steps"), STAT_YetrixCoalescedSteps, STATGROUP_Yetrix);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input latency (ms)"), STAT_YetrixInputLatency, STATGROUP_Yetrix);
+
+static TAutoConsoleVariable<bool> CVarYetrixInstancedFrozenBlocks(
+	TEXT("yetrix.InstancedFrozenBlocks"),
+	false,
+	TEXT("Draw settled blocks through one instanced mesh instead of an actor per block. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<bool> CVarYetrixSimulationThread(
+	TEXT("yetrix.SimulationThread"),
+	false,
+	TEXT("Step the simulation on a thread of its own, the game thread only shows what it reports. Not used for replays. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<float> CVarYetrixInputBufferWindow(
+	TEXT("yetrix.InputBufferWindow"),
+	inputBufferWindow,
+	TEXT("Seconds a move or rotation may wait through dropping and destroying, 0 keeps it until the next figure can take it. Recorded with the replay. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<bool> CVarYetrixLogInputLatency(
+	TEXT("yetrix.LogInputLatency"),
+	false,
+	TEXT("Log every player input with the time from the key press until the simulation used it."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<FString> CVarYetrixReplayFile(
+	TEXT("yetrix.ReplayFile"),
+	TEXT(""),
+	TEXT("Replay this input log instead of playing. Player input and saving are off while it runs. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<int32> CVarYetrixReplayTicksPerFrame(
+	TEXT("yetrix.ReplayTicksPerFrame"),
+	0,
+	TEXT("0 replays in real time, otherwise runs this many simulation ticks per frame with block actors updated once per frame."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<bool> CVarYetrixAutoplay(
+	TEXT("yetrix.Autoplay"),
+	false,
+	TEXT("The autoplayer plays the game, for attract mode and soak tests. Its moves are recorded like the player's."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarYetrixAutoplayBudgetMs(
+	TEXT("yetrix.AutoplayBudgetMs"),
+	4.f,
+	TEXT("Search time per figure, the autoplayer takes its best move so far when it runs out. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static TAutoConsoleVariable<int32> CVarYetrixAutoplayPreview(
+	TEXT("yetrix.AutoplayPreview"),
+	2,
+	TEXT("How many upcoming figures the autoplayer looks at. Read at BeginPlay."),
+	ECVF_ReadOnly);
+
+static FString GetLastSessionReplayPath() {
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Replays/LastSession.yreplay"));
+}
 
 AYetrixGameModeBase::AYetrixGameModeBase() {
 
 	PrimaryActorTick.bCanEverTick = true;
-	GameBlock::InitSubclasses();
+	BlockView::InitSubclasses();
 	PlayerControllerClass = AYetrixPlayerController::StaticClass();
 
 	InitSounds();
@@ -22,7 +101,7 @@ AYetrixGameModeBase::AYetrixGameModeBase() {
 
 bool AYetrixGameModeBase::PlaySoundWithRandomIndex(const std::string& prefix, const int count) {
 
-	const std::string finalSoundName = prefix + std::to_string(Utils::rnd0xi(count));
+	const std::string finalSoundName = prefix + std::to_string(cosmeticRnd.NextBelow(count));
 	return PlaySound(finalSoundName);
 }
 
@@ -85,711 +164,762 @@ void AYetrixGameModeBase::BeginPlay() {
 	auto* yetrixPawn = dynamic_cast<AYetrixPawn*>(pawn);
 	yetrixPawn->SetGameMode(this);
 
-	ResetGame();
-	Load();
-}
+	blockActorPool = std::make_unique<BlockActorPool>(GetWorld(), BlockView::GetActorClass());
+	blockActorPool->Prewarm(blockActorPoolPrewarmSize);
+	BlockView::SetActorPool(blockActorPool.get());
+	BlockView::SetAnimator(&blockAnimator);
 
-bool AYetrixGameModeBase::HandleDestruction()
-{
-	const auto& linesToDestruct = CheckDestruction();
-	if (linesToDestruct.empty())
-		return false;
-	
-	statePtr->fallingPositions = statePtr->blockScenePtr->GetFallingPositions(linesToDestruct);
-	statePtr->currDropState = DropState::DESTROYING;
-	statePtr->dropStateTimer = statePtr->destroyStateDuration;
+	if (CVarYetrixInstancedFrozenBlocks.GetValueOnGameThread())
+	{
+		// the block blueprint is the source of the instanced mesh and its material
+		auto* templateActor = blockActorPool->Acquire(FVector::ZeroVector);
+		const auto* meshComponent = templateActor ? templateActor->FindComponentByClass<UStaticMeshComponent>() : nullptr;
 
-	const auto howManyLines = linesToDestruct.size();
-	const int prevHundreds = statePtr->score / 100;
+		frozenBlockRenderer = std::make_unique<FrozenBlockRenderer>(this, meshComponent);
+		BlockView::SetFrozenRenderer(frozenBlockRenderer.get());
 
-	//assert(howManyLines <= 4);
-	AddScore(scorePerCombo[howManyLines - 1]);
+		blockActorPool->Release(templateActor);
+	}
 
-	const int nowHundreds = statePtr->score / 100;
+	// a saved game brings its own gameplay seed, this one only starts a fresh session
+	const uint64_t sessionSeed = FPlatformTime::Cycles64();
+	cosmeticRnd = RandomStream(sessionSeed, cosmeticRandomStream);
 
-	if (nowHundreds > prevHundreds) {
+	autosave = std::make_unique<AutosaveService>(TEXT("0"), 0);
 
-		FTimerHandle TimerHandle;
-		constexpr float sayYeahAfterSeconds = 1.f;
-		const auto* world = GetWorld();
-		world->GetTimerManager().SetTimer(TimerHandle, [this]()
-			{
-				PlaySound("yeah");
-			}, sayYeahAfterSeconds, false);
-	}
+	simulation = std::make_unique<YetrixSimulation>();
+	simulation->SetPresenter(this);
+	simulation->ResetGame(sessionSeed);
 
-	statePtr->lightAngleStart = statePtr->lightAngleCurrent;
-	statePtr->lightAngleEnd += lightZRotationAddPerExplosion;
-	statePtr->sunMoveFinishTimer = sunMoveDuration;
+	Autoplayer::Settings autoplaySettings;
+	autoplaySettings.budgetMs = CVarYetrixAutoplayBudgetMs.GetValueOnGameThread();
+	autoplaySettings.previewFigures = CVarYetrixAutoplayPreview.GetValueOnGameThread();
 
-	return true;
-}
+	autoplayer = std::make_unique<Autoplayer>(autoplaySettings);
+	autoplayer->SetParallelFor([](const int count, const std::function<void(int)>& body) {
+		ParallelFor(count, [&body](const int32 index) { body(index); });
+	});
 
-std::map<int, std::vector<IDType> > AYetrixGameModeBase::GetBlocksSortedFromLower(const Figure::Ptr figure) const
-{
-	std::map<int, std::vector<IDType> > sortedResult;
-	const std::vector<IDType>& blockIDs = figure->GetBlockIDs();
+	const FString replayPath = CVarYetrixReplayFile.GetValueOnGameThread();
+	if (!replayPath.IsEmpty() && StartReplay(replayPath))
+		return;
 
-	for (const auto blockID : blockIDs) {
-		const auto block = statePtr->blockScenePtr->GetBlock(blockID);
-		const auto logicalPos = block->GetPosition();
+	Load();
 
-		sortedResult[logicalPos.y].push_back(blockID);
-	}
+	const float bufferWindow = FMath::Max(CVarYetrixInputBufferWindow.GetValueOnGameThread(), 0.f);
+	simulation->SetInputBufferTicks(static_cast<uint64_t>(FMath::CeilToInt(bufferWindow / simulationUpdateInterval)));
+
+	// the saved game as it was read, so the replay starts from exactly the same scene
+	inputLog.Start(simulation->GetSeed(), loadedSnapshot, simulation->GetTick(), simulation->GetInputBufferTicks());
+	simulation->SetInputLog(&inputLog);
+
+	if (CVarYetrixSimulationThread.GetValueOnGameThread())
+	{
+		simulationThread = std::make_unique<SimulationThread>(*simulation);
+		simulationThread->SetTickHook([this](YetrixSimulation& threadSimulation) {
+			if (CVarYetrixAutoplay.GetValueOnAnyThread())
+				autoplayer->Drive(threadSimulation);
+		});
 
-	return sortedResult;
+		simulationThread->Start();
+	}
 }
 
-bool AYetrixGameModeBase::CheckConditionChange()
+bool AYetrixGameModeBase::StartReplay(const FString& path)
 {
-	const auto newConditionScore = GetBlockScene()->CalculateSceneConditionScore();
-	if (newConditionScore == statePtr->conditionScore)
+	TArray<uint8> bytes;
+	if (!FFileHelper::LoadFileToArray(bytes, *path))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay %s cannot be read"), *path);
 		return false;
+	}
 
-	statePtr->conditionScore = newConditionScore;
-	if (statePtr->conditionScore > worstConditionScore)
-		worstConditionScore = statePtr->conditionScore;
+	InputLog replayLog;
+	if (!replayLog.Deserialize(bytes.GetData(), bytes.Num()))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Replay %s is damaged or of another version"), *path);
+		return false;
+	}
 
-	RequestUpdateConditionScoreUI();
+	inputReplay = std::make_unique<InputReplay>(replayLog);
+	inputReplay->Start(*simulation);
+
+	replayTicksPerFrame = CVarYetrixReplayTicksPerFrame.GetValueOnGameThread();
+	replayStartSeconds = FPlatformTime::Seconds();
+
+	UE_LOG(LogTemp, Log, TEXT("Replaying %s: %u inputs over %llu ticks"), *path, static_cast<uint32>(replayLog.GetRecords().size()), replayLog.GetLength());
 	return true;
 }
 
-void AYetrixGameModeBase::OnStartDropping() {
+bool AYetrixGameModeBase::IsReplayFinished() const
+{
+	return inputReplay && inputReplay->IsFinished(*simulation);
+}
 
-	const bool deconstructed = statePtr->blockScenePtr->DeconstructFigures();
-	const bool destructionStarted = HandleDestruction();
+void AYetrixGameModeBase::FastForwardReplay()
+{
+	// nothing is shown while ticking, the views are rebuilt from the scene once afterwards
+	presentationSuppressed = true;
+	simulation->SetPresenter(nullptr);
 
-	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
-	const auto& figures = statePtr->blockScenePtr->GetFigures();
-	for (const auto& [figID, figPtr] : figures) {
-		
-		unsigned maxHeight = 0;
-		const bool canDrop = statePtr->blockScenePtr->CheckFigureCanMove(figPtr, {0, -1}, maxHeight);
-		if (!canDrop)
-			continue;
+	for (int32 i = 0; i < replayTicksPerFrame && !IsReplayFinished(); ++i)
+		SimulationTick(simulationUpdateInterval, InputPipeline::Clock::now());
 
-		const bool isLowestOne = figID == lowestFigID;
-		const bool canQuickDrop = isLowestOne && statePtr->quickDropRequested; 
-		const int heightToDrop = canQuickDrop ? maxHeight : 1;
-		
-		const auto& blocksSortedByY = GetBlocksSortedFromLower(figPtr);
-		const auto& blockIDs = figPtr->GetBlockIDs();
+	simulation->SetPresenter(this);
+	presentationSuppressed = false;
 
-		int yInd = 0;
-		size_t blockInd = 0;
+	RebuildBlockViews();
+}
 
-		for (const auto& [y, blocks] : blocksSortedByY)
-		{
-			for (const auto blockID : blocks) {
-				const auto block = statePtr->blockScenePtr->GetBlock(blockID);
-				const auto logicalPos = block->GetPosition();
-				auto dropLogicalPos = logicalPos;
-				dropLogicalPos.y -= heightToDrop;
-
-				auto fallDuration = statePtr->dropStateDuration;
-				constexpr float lowerFallDurationMultiplier = 0.25f;
-				const bool isLower = (yInd == 0);
-				
-				if (statePtr->quickDropRequested)
-				{
-					// lowest left-est block will have max speed, toppest rightest block - lowest speed (fall last)
-					fallDuration = lowerFallDurationMultiplier + (statePtr->dropStateDuration - statePtr->dropStateDuration * lowerFallDurationMultiplier) * (static_cast<float>(blockInd) / blockIDs.size());
-
-					// apply smoke effect if needed
-					if (isLower)
-					{
-						FTimerHandle TimerHandle;
-						GetWorld()->GetTimerManager().SetTimer(TimerHandle, [blockID, this]()
-							{
-								const auto blockToPuffPtr = statePtr->blockScenePtr->GetBlock(blockID);
-						blockToPuffPtr->SmokePuff();
-							}, fallDuration, false);
-					}
-				}
-				block->SetPositionAndUpdateActor(dropLogicalPos, fallDuration);
-				blockInd++;
-			}
-
-			yInd++;
-		}
-	}
+void AYetrixGameModeBase::RebuildBlockViews()
+{
+	blockViews.clear();
 
-	if (statePtr->quickDropRequested)
-	{
-		statePtr->quickDropRequested = false;
-		PlaySoundWithRandomIndex("bdysh", 3);
-	}
-		
-	const bool figureAdded = CheckAddFigures();
+	for (const auto& [blockID, blockPtr] : GetBlockScene()->GetBlocks())
+		if (blockPtr->IsAlive())
+			OnBlockAdded(*blockPtr);
+			// dying blocks would only explode once more
 
-	if (figureAdded && !destructionStarted)
-		CheckConditionChange();
+	UpdateSunlight(simulation->GetSunlightAngle());
+	RequestUpdateScoreUI();
+	RequestUpdateConditionScoreUI();
 }
 
-void AYetrixGameModeBase::UpdateSpeed()
+void AYetrixGameModeBase::SaveInputLog()
 {
-	const float speedMultiplier = std::powf(speedUpCoeff, statePtr->score / 10.f);
-
-	statePtr->stillStateDuration = stillStateInitialDuration * speedMultiplier;
-	statePtr->dropStateDuration = dropStateInitialDuration * speedMultiplier;
-}
+	inputLog.Finish(simulation->GetTick());
+	const auto data = inputLog.Serialize();
 
-void AYetrixGameModeBase::AddScore(const int score) {
+	TArray<uint8> bytes;
+	bytes.Append(data.data(), static_cast<int32>(data.size()));
 
-	statePtr->score += score;
-	RequestUpdateScoreUI();
-	UpdateSpeed();
+	const FString path = GetLastSessionReplayPath();
+	if (!FFileHelper::SaveArrayToFile(bytes, *path))
+		UE_LOG(LogTemp, Warning, TEXT("Replay %s cannot be written"), *path);
 }
 
-void AYetrixGameModeBase::UpdateSunMove(const float dt) {
+void AYetrixGameModeBase::EndPlay(const EEndPlayReason::Type endPlayReason) {
 
-	if (statePtr->sunMoveFinishTimer <= 0.f) {
-		statePtr->sunMoveFinishTimer = 0.f;
-		return;
+	// the log and the simulation are the thread's until it is joined
+	if (simulationThread)
+	{
+		simulationThread->Stop();
+		UE_LOG(LogTemp, Log, TEXT("Simulation thread: %u inputs dropped, %u presenter stalls"), simulationThread->GetDroppedInputs(), simulationThread->GetPresenterStalls());
+		simulationThread.reset();
 	}
 
-	statePtr->sunMoveFinishTimer -= dt;
+	if (simulation && !inputReplay)
+		SaveInputLog();
 
-	if (statePtr->sunMoveFinishTimer <= 0.f) {
-		statePtr->sunMoveFinishTimer = 0.f;
+	if (autosave) {
+		autosave->Flush();
+		UE_LOG(LogTemp, Log, TEXT("Autosave: %u writes, %u coalesced, %u failed, latency avg %.2f ms, max %.2f ms"),
+			autosave->GetWrites(), autosave->GetCoalesced(), autosave->GetFailures(), autosave->GetAverageLatencyMs(), autosave->GetMaxLatencyMs());
 	}
 
-	const float progress = 1.f - statePtr->sunMoveFinishTimer / sunMoveDuration;
-	const float currAngle = statePtr->lightAngleStart + (statePtr->lightAngleEnd - statePtr->lightAngleStart) * progress;
+	if (autoplayer && autoplayer->GetSearches() > 0)
+		UE_LOG(LogTemp, Log, TEXT("Autoplayer: %u searches, avg %.2f ms, max %.2f ms, %u timed out, rating cache %.1f%% hits"),
+			autoplayer->GetSearches(), autoplayer->GetAverageSearchMs(), autoplayer->GetMaxSearchMs(), autoplayer->GetTimeouts(),
+			autoplayer->GetRatingCacheStats().GetHitRate() * 100.0);
 
-	UpdateSunlight(currAngle);
-}
+	if (catchUpFrames > 0)
+		UE_LOG(LogTemp, Log, TEXT("Catch-up: %u frames, %u steps coalesced, %u steps dropped"), catchUpFrames, coalescedSteps, droppedSteps);
 
-void AYetrixGameModeBase::UpdateSunlight(const float angle) {
+	if (inputsApplied + inputsLetGo > 0)
+		UE_LOG(LogTemp, Log, TEXT("Input: %u applied, %u let go, latency avg %.2f ms, max %.2f ms"),
+			inputsApplied, inputsLetGo, inputsApplied > 0 ? inputLatencySum / inputsApplied * 1000.f : 0.f, inputLatencyMax * 1000.f);
 
-	statePtr->lightAngleCurrent = angle;
+	// the views give their actors back to the pool first
+	blockViews.clear();
 
-	TArray<AActor*> sunlightActors;
-	UGameplayStatics::GetAllActorsWithTag(GetWorld(), "Sunlight", sunlightActors);
+	if (blockActorPool) {
+		UE_LOG(LogTemp, Log, TEXT("Block actor pool: %u hits, %u misses"), blockActorPool->GetHits(), blockActorPool->GetMisses());
 
-	if (sunlightActors.IsEmpty())
-	{
-		//error
-		return;
+		BlockView::SetActorPool(nullptr);
+		blockActorPool->Clear();
 	}
 
-	const auto sunlightActor = sunlightActors[0];
-	auto rotation = sunlightActor->GetActorRotation();
-	rotation.Yaw = angle;
-	sunlightActor->SetActorRotation(rotation);
+	BlockView::SetFrozenRenderer(nullptr);
+	BlockView::SetAnimator(nullptr);
+
+	Super::EndPlay(endPlayReason);
 }
 
-void AYetrixGameModeBase::UpdateScoreUI()
+BlockView* AYetrixGameModeBase::GetBlockView(const IDType blockID) const
 {
-	if (needUpdateScoreUI > 0)
-		needUpdateScoreUI--;
-
-	const auto* world = GetWorld();
-	if (!world)
-		return;
+	const auto viewIt = blockViews.find(blockID);
+	if (viewIt == blockViews.end())
+		return nullptr;
 
-	AYetrixHUDBase* hud = Cast<AYetrixHUDBase> (world->GetFirstPlayerController()->GetHUD());
-	if (!hud)
-		return;
+	return viewIt->second.get();
+}
 
-	hud->UpdateScore(statePtr->score, hiScore);
+void AYetrixGameModeBase::OnBlockAdded(const GameBlock& block)
+{
+	auto view = std::make_unique<BlockView>(block.GetPosition(), block.IsFrozen());
+	view->CreateActor(GetWorld());
+	blockViews[block.GetID()] = std::move(view);
 }
 
-void AYetrixGameModeBase::UpdateConditionScoreUI()
+void AYetrixGameModeBase::OnBlockMoved(const GameBlock& block, const float animDuration)
 {
-	if (needUpdateConditionScoreUI > 0)
-		needUpdateConditionScoreUI--;
+	if (auto* view = GetBlockView(block.GetID()))
+		view->SetPositionAndUpdateActor(block.GetPosition(), animDuration);
+}
 
-	const auto* world = GetWorld();
-	if (!world)
-		return;
+void AYetrixGameModeBase::OnBlockFrozen(const GameBlock& block)
+{
+	if (auto* view = GetBlockView(block.GetID()))
+		view->Freeze();
+}
 
-	AYetrixHUDBase* hud = Cast<AYetrixHUDBase> (world->GetFirstPlayerController()->GetHUD());
-	if (!hud)
-		return;
+void AYetrixGameModeBase::OnBlockDestroyStarted(const GameBlock& block)
+{
+	if (auto* view = GetBlockView(block.GetID()))
+		view->StartDestroy();
+}
 
-	hud->UpdateConditionScore(statePtr->conditionScore, worstConditionScore);
+void AYetrixGameModeBase::OnBlockRemoved(const IDType blockID)
+{
+	blockViews.erase(blockID);
 }
 
-void AYetrixGameModeBase::GameOver()
+void AYetrixGameModeBase::OnBlockLanding(const IDType blockID, const float afterSeconds)
 {
-	if (statePtr->score > hiScore)
-		hiScore = statePtr->score;
+	FTimerHandle TimerHandle;
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle, [blockID, this]()
+		{
+			// block may be gone already, e.g. after a game over
+			if (auto* view = GetBlockView(blockID))
+				view->SmokePuff();
+		}, afterSeconds, false);
+}
 
-	ResetGame();
-	Save();
-	PlaySound("gameover");
+void AYetrixGameModeBase::OnFigureMoved(const Figure& figure, const Vec2D& direction)
+{
+	PlaySound(direction.x < 0 ? "k0" : "k1");
 }
 
-bool AYetrixGameModeBase::CheckAddFigures() {
+void AYetrixGameModeBase::OnFigureRotateStarted(const Figure& figure, const std::vector<Vec2D>& positions)
+{
+	PlaySound("k2");
 
-	if (statePtr->blockScenePtr->GetFigures().size() >= minFigures)
-		return false;
+	const auto& blockIDs = figure.GetBlockIDs();
 
-	const auto figureAdded = statePtr->blockScenePtr->CreateRandomFigureAt({ newFigureX, newFigureY }, GetWorld());
-	if (!figureAdded) {
-		GameOver();
-		return false;
-	}
+	std::vector<float> depthOffsets;
 
-	// apply assemble animation
-	const auto& blockIDs = figureAdded->GetBlockIDs();
-	static const std::vector<Vec2D> assembleOrigins = {
-		{-25, 25},
-		{-15, 25},
-		{25, 25},
-		{35, 25}
-	};
+	constexpr float depthOffsetMultiplier = 2.f;
+
+	const float depthOffsetCompensation = (blockIDs.size() / 2) * blockSize * depthOffsetMultiplier;
+
+	// pivot block should not change its Z
+	depthOffsets.push_back(0.f);
+
+	for (int i = 1; i < blockIDs.size(); ++i)
+		depthOffsets.push_back(i * blockSize * depthOffsetMultiplier - depthOffsetCompensation);
 
-	size_t asseblePosInd = 0;
+	int depthOffsetInd = 0;
 	for (const auto blockID : blockIDs)
 	{
-		const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockID);
+		// the view may be gone already when the calls are replayed late, the offsets still go by block order
+		auto* view = GetBlockView(blockID);
+		if (!view)
+		{
+			++depthOffsetInd;
+			continue;
+		}
 
-		const auto blockPosNeeded = blockPtr->GetPosition();
-		const Vec2D assembleFromPos = assembleOrigins[asseblePosInd];
+		const auto& worldPos = view->GetActorLocation();
+		auto newPos = worldPos;
+		newPos.Y = depthOffsets.at(depthOffsetInd);
 
-		blockPtr->SetPositionAndUpdateActor(assembleFromPos);
-		blockPtr->SetPositionAndUpdateActor(blockPosNeeded, assembleDuration);
+		view->StartAnimatedMove(rotate1StageDuration, newPos);
+		view->SetPosition(positions.at(depthOffsetInd));
 
-		asseblePosInd++;
+		++depthOffsetInd;
 	}
-
-	return true;
 }
 
-void AYetrixGameModeBase::Left() {
-	
-	statePtr->leftPending++;
-}
+void AYetrixGameModeBase::OnFigureRotateMove(const Figure& figure)
+{
+	// moving to rotated positions, but still in modified 'depth'-planes
+	for (const auto blockID : figure.GetBlockIDs())
+	{
+		auto* view = GetBlockView(blockID);
+		if (!view)
+			continue;
 
-void AYetrixGameModeBase::Right() {
+		const auto& worldPos = view->GetActorLocation();
+		auto newPos = BlockView::ToWorldPosition(view->GetPosition());
+
+		// change only XZ plane, depth (Y) should still be alterated
+		newPos.Y = worldPos.Y;	
 
-	statePtr->rightPending++;
+		view->StartAnimatedMove(rotate2StageDuration, newPos);
+	}
 }
 
-void AYetrixGameModeBase::Rotate() {
+void AYetrixGameModeBase::OnFigureRotateAssemble(const Figure& figure)
+{
+	for (const auto blockID : figure.GetBlockIDs())
+	{
+		auto* view = GetBlockView(blockID);
+		if (!view)
+			continue;
 
-	statePtr->rotatePending++;
+		const auto& worldPos = view->GetActorLocation();
+		auto newPos = worldPos;
+		newPos.Y = 0.f;
+		view->StartAnimatedMove(rotate3StageDuration, newPos);
+	}
 }
 
-void AYetrixGameModeBase::Drop() {
-	statePtr->quickDropRequested = true;
-	statePtr->dropStateTimer = 0.f;
+void AYetrixGameModeBase::OnQuickDrop()
+{
+	PlaySoundWithRandomIndex("bdysh", 3);
+}
 
+void AYetrixGameModeBase::OnSoftDrop()
+{
+	PlaySound("k2");
 }
 
-void AYetrixGameModeBase::Down() {
-	if (statePtr->currDropState == DropState::STILL)
-	{
-		PlaySound("k2");
-		statePtr->dropStateTimer = 0.f;
+void AYetrixGameModeBase::OnLinesDestroyed(const std::set<int>& lines)
+{
+	const auto linesCount = lines.size();
+
+	if (linesCount == 1) {
+		PlaySoundWithRandomIndex("bah1", 4);
+	}
+	else {
+		const std::string sound = "bah" + std::to_string(linesCount) + "0";
+		PlaySound(sound);
 	}
 }
 
-std::set<int> AYetrixGameModeBase::CheckDestruction(const BlockScene& theBlockScene)
+void AYetrixGameModeBase::OnDestroyProgress(const std::map<IDType, Vec2D>& fallingPositions, const float progress)
 {
-	std::set<int> linesToBoom;
+	// the final call still goes through, it puts the blocks back into their plane
+	if (catchingUp && progress < 1.f)
+		return;
 
-	for (int y = 1; y < checkHeight; ++y) {
-		bool hasHoles = false;
-		for (int x = 1; x < rightBorderX; ++x)
-		{
-			Vec2D checkPos(x, y);
-			const auto blockPtr = theBlockScene.GetBlock(checkPos, true);
-			if (!blockPtr || !blockPtr->IsAlive() || blockPtr->GetFigureID() != Utils::emptyID) {
-				hasHoles = true;
-				break;
-			}
-		}
+	for (const auto& [blockID, endLogicalPos] : fallingPositions)
+	{
+		auto* view = GetBlockView(blockID);
+		if (!view)
+			continue;
 
-		if (!hasHoles) {
-			linesToBoom.insert(y);
-		}
-	}
+		const auto startLogicalPos = view->GetPosition();
 
-	return linesToBoom;
-}
+		const auto blockWorldPos = BlockView::ToWorldPosition(startLogicalPos);
+		const auto dropWorldPos = BlockView::ToWorldPosition(endLogicalPos);
 
-std::set<int> AYetrixGameModeBase::CheckDestruction() {
+		const auto dropWorldPosNormalY = dropWorldPos.Y;
+		auto dropPosIntermediateY = dropWorldPosNormalY;
 
-	const std::set<int>& linesToBoom = CheckDestruction(*statePtr->blockScenePtr);
-	
-	if (!linesToBoom.empty()) {
-		const auto linesCount = linesToBoom.size();
+		const auto dYFull = destroyYShift - dropWorldPosNormalY;
 
-		if (linesCount == 1) {
-			PlaySoundWithRandomIndex("bah1", 4);
+		constexpr float progressReturnStart = 0.5f;
+
+		if (progress < progressReturnStart) {
+			dropPosIntermediateY = dropWorldPosNormalY + dYFull * (progress / progressReturnStart);
 		}
 		else {
-			const std::string sound = "bah" + std::to_string(linesCount) + "0";
-			PlaySound(sound);
+			const float returnProgress = (progress - progressReturnStart) / (1.f - progressReturnStart);
+			dropPosIntermediateY = dropWorldPosNormalY + dYFull * (1.f - returnProgress);
 		}
-	}
 
-	for (const int y : linesToBoom) {
+		const auto posDiff = dropWorldPos - blockWorldPos;
+		const auto dPosCurr = posDiff * progress;
 
-		for (int x = 1; x < rightBorderX; ++x)
-		{
-			Vec2D blockPos(x, y);
-			const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockPos, true);
-			blockPtr->StartDestroy();
-		}
-	}
+		auto dropIntermediateWorldPos = blockWorldPos + dPosCurr;
+		dropIntermediateWorldPos.Y = dropPosIntermediateY;
 
-	return linesToBoom;
+		// a move one step long, so the fall is interpolated between steps like any other move
+		view->StartAnimatedMove(simulationUpdateInterval, dropIntermediateWorldPos);
+	}
 }
 
-void AYetrixGameModeBase::FinalizeLogicalDestroy() {
+void AYetrixGameModeBase::OnScoreChanged(const int score, const int hiScore)
+{
+	reportedScore = score;
+	reportedHiScore = hiScore;
+	RequestUpdateScoreUI();
+}
 
-	for (const auto& fallingBlockInfo : statePtr->fallingPositions) {
+void AYetrixGameModeBase::OnScoreMilestone()
+{
+	FTimerHandle TimerHandle;
+	constexpr float sayYeahAfterSeconds = 1.f;
+	const auto* world = GetWorld();
+	world->GetTimerManager().SetTimer(TimerHandle, [this]()
+		{
+			PlaySound("yeah");
+		}, sayYeahAfterSeconds, false);
+}
 
-		const auto blockPtr = statePtr->blockScenePtr->GetBlock(fallingBlockInfo.first);
-		blockPtr->SetPositionAndUpdateActor(fallingBlockInfo.second);
-	}
-	
-	statePtr->fallingPositions.clear();
+void AYetrixGameModeBase::OnConditionScoreChanged(const int conditionScore, const int worstConditionScore)
+{
+	reportedConditionScore = conditionScore;
+	reportedWorstConditionScore = worstConditionScore;
+	RequestUpdateConditionScoreUI();
 }
 
-void AYetrixGameModeBase::OnStopDestroying() {
-	UpdateVisualDestroy(1.f);
-	FinalizeLogicalDestroy();
-	CheckConditionChange();
+void AYetrixGameModeBase::OnSunlightChanged(const float angle)
+{
+	if (catchingUp)
+	{
+		sunlightChangePending = true;
+		return;
+	}
 
-	Save();
+	sunlightChangePending = false;
+	UpdateSunlight(angle);
 }
 
-void AYetrixGameModeBase::OnStopDropping() {
+void AYetrixGameModeBase::OnGameOver()
+{
+	PlaySound("gameover");
 }
 
-void AYetrixGameModeBase::Save()
+void AYetrixGameModeBase::OnSaveRequested()
 {
-	json doc;
-	doc["blockScene"] = statePtr->blockScenePtr->Save();
-	doc["score"] = statePtr->score;
-	doc["hiscore"] = hiScore;
-	doc["worstConditionScore"] = worstConditionScore;
-
-	auto* saveGame = Cast<UYetrixSaveGame>(UGameplayStatics::CreateSaveGameObject(UYetrixSaveGame::StaticClass()));
-
-	const auto dumpStr = doc.dump();
-	saveGame->jsonDump = dumpStr.c_str();
+	// a replay must not overwrite the player's game
+	if (inputReplay)
+		return;
 
-	UGameplayStatics::SaveGameToSlot(saveGame, "0", 0);
+	Save();
 }
 
-bool AYetrixGameModeBase::Load()
+void AYetrixGameModeBase::OnInputHandled(const InputOutcome& outcome)
 {
-	const auto* saveGame = Cast<UYetrixSaveGame>(UGameplayStatics::LoadGameFromSlot("0", 0));
-	if (saveGame == nullptr)
+	// the thread measured it when it was handled, this call comes a frame later
+	InputOutcome measured = outcome;
+	if (!simulationThread)
+		inputPipeline.Measure(measured);
+
+	if (measured.applied)
 	{
-		return false;
+		++inputsApplied;
+		inputLatencySum += measured.latencySeconds;
+		inputLatencyMax = FMath::Max(inputLatencyMax, measured.latencySeconds);
+		SET_FLOAT_STAT(STAT_YetrixInputLatency, measured.latencySeconds * 1000.f);
+	}
+	else
+	{
+		++inputsLetGo;
 	}
 
-	const std::string dataStr(TCHAR_TO_UTF8(*saveGame->jsonDump));
-	json doc = json::parse(dataStr);
-
-	statePtr->blockScenePtr->Load(doc["blockScene"], GetWorld());
-	statePtr->score = doc["score"].get<int>();
-	hiScore = doc["hiscore"].get<int>();
-	worstConditionScore = doc["worstConditionScore"].get<int>();
-
-	RequestUpdateScoreUI();
-	CheckConditionChange();
-	UpdateSpeed();
-
-	return true;
+	if (CVarYetrixLogInputLatency.GetValueOnGameThread())
+		UE_LOG(LogTemp, Log, TEXT("Input %u (%d): %s at tick %llu, %llu ticks after it arrived, %.2f ms after the press"),
+			measured.tag, static_cast<int32>(measured.type), measured.applied ? TEXT("applied") : TEXT("let go"),
+			measured.handledTick, measured.handledTick - measured.arrivalTick, measured.latencySeconds * 1000.f);
 }
 
-bool AYetrixGameModeBase::CheckChangeDropState() {
+void AYetrixGameModeBase::UpdateSunlight(const float angle) {
 
-	if (statePtr->dropStateTimer >= 0.f)
-		return false;
+	TArray<AActor*> sunlightActors;
+	UGameplayStatics::GetAllActorsWithTag(GetWorld(), "Sunlight", sunlightActors);
 
-	if (statePtr->currDropState == DropState::ROTATING) {
-		statePtr->currDropState = DropState::STILL;
-		statePtr->dropStateTimer = statePtr->stillStateDuration;
+	if (sunlightActors.IsEmpty())
+	{
+		//error
+		return;
 	}
 
-	if (statePtr->currDropState == DropState::STILL) {
-		statePtr->currDropState = DropState::DROPPING;
-		statePtr->dropStateTimer = statePtr->dropStateDuration;	
-		OnStartDropping();
-	}
-	else if (statePtr->currDropState == DropState::DROPPING) {
-		statePtr->currDropState = DropState::STILL;
-		statePtr->dropStateTimer = statePtr->stillStateDuration;
+	const auto sunlightActor = sunlightActors[0];
+	auto rotation = sunlightActor->GetActorRotation();
+	rotation.Yaw = angle;
+	sunlightActor->SetActorRotation(rotation);
+}
 
-		if (statePtr->quickDropRequested)
-			statePtr->dropStateTimer = 0.f;
-			// should drop quickly, don't wait in STILL state
+void AYetrixGameModeBase::UpdateScoreUI()
+{
+	if (needUpdateScoreUI > 0)
+		needUpdateScoreUI--;
 
-		OnStopDropping();
-	}
-	else if (statePtr->currDropState == DropState::DESTROYING) {
-		statePtr->currDropState = DropState::STILL;
-		statePtr->dropStateTimer = statePtr->stillStateDuration;
-		OnStopDestroying();
-	}
+	const auto* world = GetWorld();
+	if (!world)
+		return;
 
-	return true;
+	AYetrixHUDBase* hud = Cast<AYetrixHUDBase> (world->GetFirstPlayerController()->GetHUD());
+	if (!hud)
+		return;
+
+	// the thread's calls may come a tick ahead of or behind its snapshot, the reported values go with the calls
+	if (simulationThread)
+		hud->UpdateScore(reportedScore, reportedHiScore);
+	else
+		hud->UpdateScore(simulation->GetScore(), simulation->GetHiScore());
 }
 
-void AYetrixGameModeBase::RequestUpdateConditionScoreUI()
+void AYetrixGameModeBase::UpdateConditionScoreUI()
 {
-	needUpdateConditionScoreUI++;
+	if (needUpdateConditionScoreUI > 0)
+		needUpdateConditionScoreUI--;
+
+	const auto* world = GetWorld();
+	if (!world)
+		return;
+
+	AYetrixHUDBase* hud = Cast<AYetrixHUDBase> (world->GetFirstPlayerController()->GetHUD());
+	if (!hud)
+		return;
+
+	if (simulationThread)
+		hud->UpdateConditionScore(reportedConditionScore, reportedWorstConditionScore);
+	else
+		hud->UpdateConditionScore(simulation->GetConditionScore(), simulation->GetWorstConditionScore());
 }
 
-void AYetrixGameModeBase::RequestUpdateScoreUI()
-{
-	needUpdateScoreUI++;
+void AYetrixGameModeBase::SendInput(const InputType type) {
+
+	// stamped now, applied before the first tick due after it
+	const InputPipeline::Press press = inputPipeline.Capture(type);
+	if (simulationThread)
+		simulationThread->PushInput(press);
+	else
+		inputPipeline.Add(press);
 }
 
-void AYetrixGameModeBase::ResetGame() {
+void AYetrixGameModeBase::Left() {
 
-	statePtr = std::make_unique<State>();
-	worstConditionScore = 0;
-	RequestUpdateScoreUI();
-	UpdateSunlight(lightZRotationInit);
+	if (inputReplay)
+		return;
+	
+	SendInput(InputType::LEFT);
 }
 
-void AYetrixGameModeBase::UpdateVisualDestroy(const float progress) {
+void AYetrixGameModeBase::Right() {
 
-	for (const auto& [blockID, endLogicalPos] : statePtr->fallingPositions)
-	{
-		const auto block = statePtr->blockScenePtr->GetBlock(blockID);
-		const auto startLogicalPos = block->GetPosition();
+	if (inputReplay)
+		return;
 
-		const auto blockWorldPos = GameBlock::ToWorldPosition(startLogicalPos);
-		const auto dropWorldPos = GameBlock::ToWorldPosition(endLogicalPos);
+	SendInput(InputType::RIGHT);
+}
 
-		const auto dropWorldPosNormalY = dropWorldPos.Y;
-		auto dropPosIntermediateY = dropWorldPosNormalY;
+void AYetrixGameModeBase::Rotate() {
 
-		const auto dYFull = destroyYShift - dropWorldPosNormalY;
+	if (inputReplay)
+		return;
 
-		constexpr float progressReturnStart = 0.5f;
+	SendInput(InputType::ROTATE);
+}
 
-		if (progress < progressReturnStart) {
-			dropPosIntermediateY = dropWorldPosNormalY + dYFull * (progress / progressReturnStart);
-		}
-		else {
-			const float returnProgress = (progress - progressReturnStart) / (1.f - progressReturnStart);
-			dropPosIntermediateY = dropWorldPosNormalY + dYFull * (1.f - returnProgress);
-		}
+void AYetrixGameModeBase::Drop() {
 
-		const auto posDiff = dropWorldPos - blockWorldPos;
-		const auto dPosCurr = posDiff * progress;
+	if (inputReplay)
+		return;
 
-		auto dropIntermediateWorldPos = blockWorldPos + dPosCurr;
-		dropIntermediateWorldPos.Y = dropPosIntermediateY;
+	SendInput(InputType::DROP);
+}
 
-		block->SetActorLocation(dropIntermediateWorldPos);
-	}
+void AYetrixGameModeBase::Down() {
+
+	if (inputReplay)
+		return;
+
+	SendInput(InputType::DOWN);
 }
 
-std::set<AYetrixGameModeBase::FigureBlockPositions> AYetrixGameModeBase::GetAllPossibleNewFigureBlockPositionsForAI() const
+void AYetrixGameModeBase::Save()
 {
-	std::set<FigureBlockPositions> figureBlockPositions;
+	SCOPE_CYCLE_COUNTER(STAT_YetrixSave);
 
-	//const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
-	//if (lowestFigID == Utils::emptyID)
-	//	return {};
+	// only the snapshot is taken here, the disk write happens on a pool thread; the simulation thread
+	// takes it itself, along with the request
+	auto data = simulationThread ? simulationThread->GetDispatchedSave() : simulation->SaveBinary();
+	SET_DWORD_STAT(STAT_YetrixSaveSize, data.size());
 
-	//const auto& figure = statePtr->blockScenePtr->GetFigures().at(lowestFigID);
+	autosave->Request(std::move(data));
+}
 
-	//const auto rotatedPositionsForFigure = statePtr->blockScenePtr->GetRotatedPositions(figure);;
+bool AYetrixGameModeBase::Load()
+{
+	const auto* saveGame = Cast<UYetrixSaveGame>(UGameplayStatics::LoadGameFromSlot("0", 0));
+	if (saveGame == nullptr)
+	{
+		return false;
+	}
 
-	//for (const auto blockRotatedPosition : rotatedPositionsForFigure) {\}
+	SCOPE_CYCLE_COUNTER(STAT_YetrixLoad);
 
-	//// wrap it into rotation cycle and position cycle
-	//FigureBlockPositions positions;
+	const auto& binaryDump = saveGame->binaryDump;
+	if (!binaryDump.IsEmpty())
+	{
+		const bool loaded = simulation->LoadBinary(binaryDump.GetData(), binaryDump.Num());
+		if (loaded)
+			loadedSnapshot.assign(reinterpret_cast<const char*>(binaryDump.GetData()), binaryDump.Num());
 
-	//unsigned heightToDrop = 0;
-	//const bool canDrop = statePtr->blockScenePtr->CheckFigureCanMove(figure, {0, -1}, heightToDrop);
+		return loaded;
+	}
 
-	//const auto& blockIDs = figure->GetBlockIDs();
-	//for (const auto blockID : blockIDs)
-	//{
-	//	const auto block = GetBlockScene()->GetBlock(blockID);
-	//	const auto blockPos = block->GetPosition();
+	// saved before the binary format, the next save converts it
+	const std::string dataStr(TCHAR_TO_UTF8(*saveGame->jsonDump));
+	const json doc = json::parse(dataStr);
 
-	//	const Vec2D newPos = {blockPos.x, blockPos.y + heightToDrop};
-	//	positions.emplace(blockID, newPos);
-	//}
+	const bool loaded = simulation->Load(doc);
+	if (loaded)
+		loadedSnapshot = dataStr;
 
-	return figureBlockPositions;
+	return loaded;
 }
 
-bool AYetrixGameModeBase::TryRotate()
+void AYetrixGameModeBase::RequestUpdateConditionScoreUI()
 {
-	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
+	needUpdateConditionScoreUI++;
+}
 
-	if (lowestFigID == Utils::emptyID)
-		return false;
-		// nothing to rotate
+void AYetrixGameModeBase::RequestUpdateScoreUI()
+{
+	needUpdateScoreUI++;
+}
 
-	const auto& figure = statePtr->blockScenePtr->GetFigures().at(lowestFigID);
-	rotatedPositions = statePtr->blockScenePtr->GetRotatedPositions(figure);
-	const bool canRotate = !rotatedPositions.empty();
-	if (!canRotate)
-		return false;
-	
-	PlaySound("k2");
+std::vector<AYetrixGameModeBase::FigureBlockPositions> AYetrixGameModeBase::GetAllPossibleNewFigureBlockPositionsForAI() const
+{
+	const auto& blockScene = *simulation->GetBlockScene();
 
-	statePtr->currDropState = DropState::ROTATING;
-	statePtr->dropStateTimer = rotateStateInitialDuration;
-	statePtr->currRotateState = RotateSubState::BREAK_1;
+	const auto lowestFigID = blockScene.GetLowestFigureID();
+	if (lowestFigID == Utils::emptyID)
+		return {};
 
-	const auto& blockIDs = figure->GetBlockIDs();
+	const auto& figure = *blockScene.GetFigures().at(lowestFigID);
+	const auto& blockIDs = figure.GetBlockIDs();
 
-	std::vector<float> depthOffsets;
+	std::vector<FigureBlockPositions> figureBlockPositions;
+	for (const auto& placement : PlacementEnumerator::Enumerate(blockScene, figure))
+	{
+		FigureBlockPositions positions;
+		for (size_t i = 0; i < blockIDs.size(); ++i)
+			positions.emplace(blockIDs[i], placement.positions[i]);
 
-	constexpr float depthOffsetMultiplier = 2.f;
+		figureBlockPositions.push_back(positions);
+	}
 
-	const float depthOffsetCompensation = (blockIDs.size() / 2) * blockSize * depthOffsetMultiplier;
+	return figureBlockPositions;
+}
 
-	// pivot block should not change its Z
-	depthOffsets.push_back(0.f);
+void AYetrixGameModeBase::SimulationTick(float dt, const InputPipeline::Clock::time_point tickTime) {
 
-	for (int i = 1; i < blockIDs.size(); ++i)
-		depthOffsets.push_back(i * blockSize * depthOffsetMultiplier - depthOffsetCompensation);
+	SCOPE_CYCLE_COUNTER(STAT_YetrixSimulationTick);
+	SET_DWORD_STAT(STAT_YetrixSceneBlocks, simulation->GetBlockScene()->GetBlocks().size());
 
-	int depthOffsetInd = 0;
-	for (const auto blockID : blockIDs)
+	if (inputReplay)
+		inputReplay->Feed(*simulation);
+	else
 	{
-		const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockID);
+		inputPipeline.Feed(*simulation, tickTime);
 
-		const auto& worldPos = blockPtr->GetActorLocation();
-		auto newPos = worldPos;
-		newPos.Y = depthOffsets.at(depthOffsetInd);
+		if (autoplayer && CVarYetrixAutoplay.GetValueOnGameThread())
+		{
+			SCOPE_CYCLE_COUNTER(STAT_YetrixAutoplayer);
+			autoplayer->Drive(*simulation);
+		}
+	}
 
-		blockPtr->StartAnimatedMove(rotate1StageDuration, newPos);
-		blockPtr->SetPosition(rotatedPositions.at(blockID));
+	simulation->Tick(dt);
 
-		statePtr->currRotateState = RotateSubState::BREAK_1;
-		++depthOffsetInd;
-	}
+	if (presentationSuppressed)
+		return;
 
-	return true;
+	// moves started during a catch-up get the whole frame at once, which only ends them sooner
+	animatorDtPending += dt;
+	if (catchingUp)
+		return;
+
+	blockAnimator.Tick(animatorDtPending);
+	animatorDtPending = 0.f;
+
+	SET_DWORD_STAT(STAT_YetrixMovingBlocks, blockAnimator.GetMovingCount());
+	SET_DWORD_STAT(STAT_YetrixSettlingBlocks, blockAnimator.GetSettlingCount());
 }
 
-void AYetrixGameModeBase::HandleRotateAnimation()
-{
-	const float elapsed = rotateStateInitialDuration - statePtr->dropStateTimer;
-	if (elapsed < rotate1StageDuration)
-	{
-		// visual 'break' in progress, no actions needed
-		return;
-	}
+void AYetrixGameModeBase::ThreadedSimulationTick(const float dt) {
 
-	const auto lowestFigID = statePtr->blockScenePtr->GetLowestFigureID();
-	const auto& figure = statePtr->blockScenePtr->GetFigures().at(lowestFigID);
-	const auto& blockIDs = figure->GetBlockIDs();
-	
-	if (statePtr->currRotateState == RotateSubState::BREAK_1 && elapsed < rotate1StageDuration + rotate2StageDuration)
-	{
-		// moving to rotated positions, but still in modified 'depth'-planes
-		for (const auto blockID : blockIDs)
-		{
-			const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockID);
-			const auto& worldPos = blockPtr->GetActorLocation();
-			auto newPos = GameBlock::ToWorldPosition(rotatedPositions.at(blockID));
+	simulationThread->DispatchCalls(*this);
+	SET_DWORD_STAT(STAT_YetrixSceneBlocks, simulationThread->GetSnapshot().blocks.size());
 
-			// change only XZ plane, depth (Y) should still be alterated
-			newPos.Y = worldPos.Y;	
+	// the calls come in at frame rate already, moves run on frame time
+	blockAnimator.Tick(dt);
+	blockAnimator.Present(1.f);
 
-			blockPtr->StartAnimatedMove(rotate2StageDuration, newPos);
-		}
+	SET_DWORD_STAT(STAT_YetrixMovingBlocks, blockAnimator.GetMovingCount());
+	SET_DWORD_STAT(STAT_YetrixSettlingBlocks, blockAnimator.GetSettlingCount());
+}
 
-		statePtr->currRotateState = RotateSubState::MOVE_2;
-	}
-	else if (statePtr->currRotateState == RotateSubState::MOVE_2 && elapsed > rotate1StageDuration + rotate2StageDuration)
+void AYetrixGameModeBase::Tick(float dt) {
+
+	if (IsReplayFinished())
 	{
-		for (const auto blockID : blockIDs)
+		if (!replayFinishReported)
 		{
-			const auto blockPtr = statePtr->blockScenePtr->GetBlock(blockID);
-			const auto& worldPos = blockPtr->GetActorLocation();
-			auto newPos = worldPos;
-			newPos.Y = 0.f;
-			blockPtr->StartAnimatedMove(rotate3StageDuration, newPos);
+			const double replaySeconds = FPlatformTime::Seconds() - replayStartSeconds;
+			UE_LOG(LogTemp, Log, TEXT("Replay finished: %llu ticks in %.3f s, score %d"), inputReplay->GetTicksPlayed(*simulation), replaySeconds, simulation->GetScore());
+			replayFinishReported = true;
 		}
-
-		statePtr->currRotateState = RotateSubState::ASSEMBLE_3;
 	}
-}
-
-void AYetrixGameModeBase::HandlePlayerPendingInput()
-{
-	while (statePtr->leftPending)
+	else if (inputReplay && replayTicksPerFrame > 0)
 	{
-		statePtr->leftPending--;
-
-		const bool moveOk = statePtr->blockScenePtr->TryMoveBlock({-1, 0});
-		if (moveOk)
-			PlaySound("k0");
-		else
-			break;
-	}
-	while (statePtr->rightPending) {
-
-		statePtr->rightPending--;
-		const bool moveOk = statePtr->blockScenePtr->TryMoveBlock({1, 0});
-		if (moveOk)
-			PlaySound("k1");
-		else
-			break;
+		FastForwardReplay();
 	}
-
-	while (statePtr->rotatePending)
+	else if (simulationThread)
 	{
-		statePtr->rotatePending--;
-
-		const bool rotated = TryRotate();
-		if (!rotated) 
-			break;
+		ThreadedSimulationTick(dt);
 	}
-}
-
-void AYetrixGameModeBase::SimulationTick(float dt) {
+	else
+	{
+		dtAccum += dt;
 
-	UpdateSunMove(dt);
+		// the game slows down rather than spending every next frame catching up
+		const int32 backlogSteps = static_cast<int32>(dtAccum / simulationUpdateInterval);
+		if (backlogSteps > maxCatchUpSteps)
+		{
+			droppedSteps += backlogSteps - maxCatchUpSteps;
+			dtAccum -= (backlogSteps - maxCatchUpSteps) * simulationUpdateInterval;
+		}
 
-	statePtr->dropStateTimer -= dt;
-	CheckChangeDropState();
+		// a step stands for the moment the leftover time ago, its presses are the ones made by then
+		const auto frameTime = InputPipeline::Clock::now();
 
-	if (statePtr->currDropState == DropState::ROTATING) {
+		int32 steps = 0;
+		while (dtAccum >= simulationUpdateInterval && !IsReplayFinished())
+		{
+			dtAccum -= simulationUpdateInterval;
+			catchingUp = dtAccum >= simulationUpdateInterval;
 
-		// handling rotating substate
-		HandleRotateAnimation();
-	}
+			const auto tickTime = frameTime - std::chrono::duration_cast<InputPipeline::Clock::duration>(std::chrono::duration<float>(dtAccum));
+			SimulationTick(simulationUpdateInterval, tickTime);
+			++steps;
+		}
 
-	if (statePtr->currDropState == DropState::DESTROYING) {
+		// a replay may end in the middle of a catch-up
+		if (catchingUp)
+		{
+			catchingUp = false;
+			blockAnimator.Tick(animatorDtPending);
+			animatorDtPending = 0.f;
+		}
 
-		const float dropProgress = 1.f - (statePtr->dropStateTimer / statePtr->destroyStateDuration);
-		UpdateVisualDestroy(dropProgress);
-	}
-	else if (statePtr->currDropState == DropState::DROPPING) {
+		if (sunlightChangePending)
+			OnSunlightChanged(simulation->GetSunlightAngle());
 
-		// no action required
+		if (steps > 1)
+		{
+			++catchUpFrames;
+			coalescedSteps += steps - 1;
+		}
 
-	} else {
+		SET_DWORD_STAT(STAT_YetrixCoalescedSteps, steps > 1 ? steps - 1 : 0);
 
-		//STILL or ROTATING	
-		HandlePlayerPendingInput();
+		// the leftover time is how far the display is between the last two steps
+		blockAnimator.Present(dtAccum / simulationUpdateInterval);
 	}
 
-	statePtr->blockScenePtr->Tick(dt);
-}
-
-void AYetrixGameModeBase::Tick(float dt) {
+	if (frozenBlockRenderer)
+		frozenBlockRenderer->Flush();
 
-	dtAccum += dt;
-	while (dtAccum >= simulationUpdateInterval)
-	{
-		dtAccum -= simulationUpdateInterval;
-		SimulationTick(simulationUpdateInterval);
-	}
+	if (autosave)
+		autosave->Tick();
 
 	if (needUpdateScoreUI > 0)
 		UpdateScoreUI();
@@ -3,7 +3,15 @@
 #include "CoreMinimal.h"
 #include "GameFramework/GameModeBase.h"
 
-#include "BlockScene.h"
+#include "YetrixSimulation.h"
+#include "SimulationThread.h"
+#include "InputPipeline.h"
+#include "BlockView.h"
+#include "BlockActorPool.h"
+#include "BlockAnimator.h"
+#include "FrozenBlockRenderer.h"
+#include "AutosaveService.h"
+#include "Autoplayer.h"
 #include "YetrixConfig.h"
 
 #include "YetrixGameModeBase.generated.h"
@@ -12,44 +20,15 @@
  * 
  */
 UCLASS()
-class YETRIX_API AYetrixGameModeBase : public AGameModeBase
+class YETRIX_API AYetrixGameModeBase : public AGameModeBase, public SimulationPresenter
 {
 	GENERATED_BODY()
 
 	AYetrixGameModeBase();
-	
-	enum class DropState {
-		STILL,
-		DROPPING,
-		DESTROYING,
-		ROTATING
-	};
-
-	enum class RotateSubState
-	{
-		BREAK_1,
-		MOVE_2,
-		ASSEMBLE_3,
-		STATIC
-	};
-
-	bool CheckChangeDropState();
-
-	void ResetGame();
 
 	void Save();
 	bool Load();
 
-	bool HandleDestruction();
-	std::map<int, std::vector<IDType>> GetBlocksSortedFromLower(const Figure::Ptr figurePtr) const;
-	void OnStartDropping();
-	void OnStopDropping();
-	void OnStopDestroying();
-	
-	void FinalizeLogicalDestroy();
-	std::set<int> CheckDestruction();
-	static std::set<int> CheckDestruction(const BlockScene& theBlockScene);
-
 	void InitSounds();
 
 	bool PlaySoundWithRandomIndex(const std::string& prefix, const int count);
@@ -57,82 +36,107 @@ class YETRIX_API AYetrixGameModeBase : public AGameModeBase
 
 	std::map<std::string, USoundWave*> soundsMap;
 
-	struct State {
-
-		State() {
-			blockScenePtr = std::make_unique<BlockScene>();
-		}
-
-		DropState currDropState = DropState::STILL;
-		RotateSubState currRotateState = RotateSubState::STATIC;
-
-		float dropStateTimer = 0.f;
-		float stillStateDuration = stillStateInitialDuration;
-		float dropStateDuration = dropStateInitialDuration;
-		float destroyStateDuration = destroyingStateInitialDuration;
-
-		bool quickDropRequested = false;
-
-		int leftPending = 0;
-		int rightPending = 0;
-		int rotatePending = 0;
-
-		int score = 0;
-		int conditionScore = 0;
+	// sounds and other effects, kept apart from the gameplay stream inside the simulation
+	RandomStream cosmeticRnd;
 
-		float lightAngleCurrent = 0.f;
-
-		float lightAngleStart = 0.f;
-		float lightAngleEnd = 0.f;
-		float sunMoveFinishTimer = 0.f;
+	float dtAccum = 0.f;
 
-		std::map<IDType, Vec2D> fallingPositions;
-		std::unique_ptr<BlockScene> blockScenePtr;
-	};
+	// set for all but the last step of a frame, their actor updates would be overwritten right away
+	bool catchingUp = false;
+	bool sunlightChangePending = false;
+	float animatorDtPending = 0.f;
 
-	float dtAccum = 0.f;
+	uint32 catchUpFrames = 0;
+	uint32 coalescedSteps = 0;
+	uint32 droppedSteps = 0;
 
 	int needUpdateScoreUI = 0;
 	int needUpdateConditionScoreUI = 0;
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
 	virtual void Tick(float dt) override;
 
-	void SimulationTick(float dt);
-	bool CheckAddFigures();
-	bool TryRotate();
-	void HandleRotateAnimation();
-	void HandlePlayerPendingInput();
-	void UpdateVisualDestroy(float progress);
+	void SimulationTick(float dt, InputPipeline::Clock::time_point tickTime);
+	void ThreadedSimulationTick(float dt);
+	void SendInput(InputType type);
+
+	bool StartReplay(const FString& path);
+	bool IsReplayFinished() const;
+	void FastForwardReplay();
+	void RebuildBlockViews();
+	void SaveInputLog();
 	
-	void AddScore(const int score);
 	void UpdateScoreUI();
 	void UpdateConditionScoreUI();
-	void GameOver();
 	void RequestUpdateScoreUI();
 	void RequestUpdateConditionScoreUI();
 	void UpdateSunlight(const float angle);
-	void UpdateSunMove(const float dt);
-
-	void UpdateSpeed();
-
-	bool CheckConditionChange();
 
-	struct BlockAtPosition
-	{
-		BlockAtPosition(IDType id, const Vec2D& pos) : blockID(id), position(pos) {}
-
-		IDType blockID = Utils::emptyID;
-		Vec2D position;
-	};
-
-	typedef std::set<BlockAtPosition> FigureBlockPositions;
-
-	std::set<FigureBlockPositions> GetAllPossibleNewFigureBlockPositionsForAI() const;
-
-	std::unique_ptr<State> statePtr;
-	int hiScore = 0;
-	int worstConditionScore = 0;
+	BlockView* GetBlockView(IDType blockID) const;
+
+	// SimulationPresenter
+	virtual void OnBlockAdded(const GameBlock& block) override;
+	virtual void OnBlockMoved(const GameBlock& block, float animDuration) override;
+	virtual void OnBlockFrozen(const GameBlock& block) override;
+	virtual void OnBlockDestroyStarted(const GameBlock& block) override;
+	virtual void OnBlockRemoved(IDType blockID) override;
+	virtual void OnBlockLanding(IDType blockID, float afterSeconds) override;
+	virtual void OnFigureMoved(const Figure& figure, const Vec2D& direction) override;
+	virtual void OnFigureRotateStarted(const Figure& figure, const std::vector<Vec2D>& positions) override;
+	virtual void OnFigureRotateMove(const Figure& figure) override;
+	virtual void OnFigureRotateAssemble(const Figure& figure) override;
+	virtual void OnQuickDrop() override;
+	virtual void OnSoftDrop() override;
+	virtual void OnLinesDestroyed(const std::set<int>& lines) override;
+	virtual void OnDestroyProgress(const std::map<IDType, Vec2D>& fallingPositions, float progress) override;
+	virtual void OnScoreChanged(int score, int hiScore) override;
+	virtual void OnScoreMilestone() override;
+	virtual void OnConditionScoreChanged(int conditionScore, int worstConditionScore) override;
+	virtual void OnSunlightChanged(float angle) override;
+	virtual void OnGameOver() override;
+	virtual void OnSaveRequested() override;
+	virtual void OnInputHandled(const InputOutcome& outcome) override;
+
+	// block positions by block ID, one entry per distinct placement of the lowest figure
+	typedef std::map<IDType, Vec2D> FigureBlockPositions;
+
+	std::vector<FigureBlockPositions> GetAllPossibleNewFigureBlockPositionsForAI() const;
+
+	// declared before the views, so blocks give their actors back before the pool goes away
+	std::unique_ptr<BlockActorPool> blockActorPool;
+	std::unique_ptr<FrozenBlockRenderer> frozenBlockRenderer;
+	BlockAnimator blockAnimator;
+
+	std::map<IDType, BlockView::Ptr> blockViews;
+	std::unique_ptr<YetrixSimulation> simulation;
+
+	// when set, the simulation steps on its own thread and is only reached through it
+	std::unique_ptr<SimulationThread> simulationThread;
+
+	// player presses, stamped as they come in
+	InputPipeline inputPipeline;
+	uint32 inputsApplied = 0;
+	uint32 inputsLetGo = 0;
+	float inputLatencySum = 0.f;
+	float inputLatencyMax = 0.f;
+	int reportedScore = 0;
+	int reportedHiScore = 0;
+	int reportedConditionScore = 0;
+	int reportedWorstConditionScore = 0;
+
+	std::unique_ptr<AutosaveService> autosave;
+	std::unique_ptr<Autoplayer> autoplayer;
+
+	// this session's input, written to Saved/Replays at EndPlay
+	InputLog inputLog;
+	std::string loadedSnapshot;
+
+	std::unique_ptr<InputReplay> inputReplay;
+	int32 replayTicksPerFrame = 0;
+	double replayStartSeconds = 0.0;
+	bool replayFinishReported = false;
+	bool presentationSuppressed = false;
 
 public:
 	void Left();
@@ -141,8 +145,6 @@ public:
 	void Down();
 	void Rotate();
 
-	const BlockScene* GetBlockScene() const {return statePtr->blockScenePtr.get();}
-
-private:
-	std::map<IDType, Vec2D> rotatedPositions;
-};
+	// not while the simulation thread runs
+	const BlockScene* GetBlockScene() const {return simulation->GetBlockScene();}
+};
\ No newline at end of file
@@ -15,6 +15,11 @@ class YETRIX_API UYetrixSaveGame : public USaveGame
 	GENERATED_BODY()
 
 public:
+	// YetrixSimulation::SaveBinary output
+	UPROPERTY()
+	TArray<uint8> binaryDump;
+
+	// legacy format, only read when binaryDump is empty
 	UPROPERTY()
 	FString jsonDump;
 };
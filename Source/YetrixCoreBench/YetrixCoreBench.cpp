@@ -0,0 +1,384 @@
+// Headless runs of the simulation, reports simulation steps per second.
+// Same seed gives the same game, so the final line is comparable between runs.
+//
+// Usage:
+//   YetrixCoreBench [ticks] [seed] [record.yreplay]   random input, optionally recorded
+//   YetrixCoreBench --replay file.yreplay              replays a recorded session as fast as possible
+//   YetrixCoreBench --autoplay [ticks] [seed] [budget ms] [classic|wide|huge]   the autoplayer plays, searching on all cores
+//   YetrixCoreBench --boards [figures] [seed]          scene alone on every board preset, figures dropped at random
+//   YetrixCoreBench --thread [ticks] [seed]            the plain run on a SimulationThread, same results expected
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+#include "Autoplayer.h"
+#include "InputLog.h"
+#include "PlacementEnumerator.h"
+#include "SimulationThread.h"
+#include "YetrixSimulation.h"
+
+#include "3rdparty/nlohmann/json.hpp"
+
+class BenchPresenter : public SimulationPresenter {
+public:
+	void OnLinesDestroyed(const std::set<int>& lines) override {linesDestroyed += static_cast<unsigned>(lines.size());}
+	void OnGameOver() override {++gamesOver;}
+
+	unsigned linesDestroyed = 0;
+	unsigned gamesOver = 0;
+};
+
+static void PrintCacheStats(const char* name, const TranspositionTable::Stats& stats) {
+	std::printf("%s: %llu lookups, %.1f%% hits\n", name, static_cast<unsigned long long>(stats.lookups), stats.GetHitRate() * 100.0);
+}
+
+template <typename Board> static void PrintResult(const BasicYetrixSimulation<Board>& simulation, const BenchPresenter& presenter, const unsigned long long ticks, const double seconds, const unsigned long long blocksSum) {
+
+	std::printf("ticks: %llu, %.3f s, %.0f ticks/s, %.1f ns/tick\n", ticks, seconds, ticks / seconds, seconds * 1e9 / ticks);
+	std::printf("avg blocks: %.1f, lines: %u, games over: %u\n", static_cast<double>(blocksSum) / ticks, presenter.linesDestroyed, presenter.gamesOver);
+	std::printf("final seed: %llu, score: %d, hiscore: %d\n", static_cast<unsigned long long>(simulation.GetSeed()), simulation.GetScore(), simulation.GetHiScore());
+}
+
+// about one input every 25 ticks
+static void ApplyRandomInput(YetrixSimulation& simulation, RandomStream& inputRnd) {
+
+	switch (inputRnd.NextBelow(100)) {
+		case 0: simulation.Left(); break;
+		case 1: simulation.Right(); break;
+		case 2: simulation.Rotate(); break;
+		case 3: simulation.Drop(); break;
+		default: break;
+	}
+}
+
+template <typename Func> static double MeasureMicroseconds(const int iterations, Func&& func) {
+
+	const auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		func();
+
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / iterations;
+}
+
+// both formats as the game mode uses them: JSON goes through a string dump, binary is stored as is
+static void CompareSaves(YetrixSimulation& simulation) {
+
+	constexpr int iterations = 1000;
+
+	std::string jsonDump;
+	const double jsonSave = MeasureMicroseconds(iterations, [&]() { jsonDump = simulation.Save().dump(); });
+	const double jsonLoad = MeasureMicroseconds(iterations, [&]() { simulation.Load(json::parse(jsonDump)); });
+
+	std::vector<uint8_t> binaryDump;
+	const double binarySave = MeasureMicroseconds(iterations, [&]() { binaryDump = simulation.SaveBinary(); });
+	const double binaryLoad = MeasureMicroseconds(iterations, [&]() { simulation.LoadBinary(binaryDump.data(), binaryDump.size()); });
+
+	std::printf("json save: %zu bytes, save %.2f us, load %.2f us\n", jsonDump.size(), jsonSave, jsonLoad);
+	std::printf("binary save: %zu bytes, save %.2f us, load %.2f us\n", binaryDump.size(), binarySave, binaryLoad);
+}
+
+// enumerates the lowest figure's placements on boards sampled from the finished run
+static void MeasurePlacements(const YetrixSimulation& simulation) {
+
+	constexpr int iterations = 10000;
+
+	const auto& scene = *simulation.GetBlockScene();
+	const auto lowestFigID = scene.GetLowestFigureID();
+	if (lowestFigID == Utils::emptyID) {
+		std::printf("placements: no figure on the final board\n");
+		return;
+	}
+
+	const auto& figure = *scene.GetFigures().at(lowestFigID);
+
+	size_t placementsCount = 0;
+	const double enumerate = MeasureMicroseconds(iterations, [&]() { placementsCount = PlacementEnumerator::Enumerate(scene, figure).size(); });
+
+	std::printf("placements: %zu, enumerate %.3f us\n", placementsCount, enumerate);
+}
+
+static int Replay(const char* path) {
+
+	std::ifstream file(path, std::ios::binary);
+	const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	InputLog log;
+	if (!log.Deserialize(bytes.data(), bytes.size())) {
+		std::fprintf(stderr, "cannot read replay %s\n", path);
+		return 1;
+	}
+
+	BenchPresenter presenter;
+	YetrixSimulation simulation;
+	simulation.SetPresenter(&presenter);
+
+	InputReplay replay(log);
+	replay.Start(simulation);
+
+	unsigned long long blocksSum = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	while (!replay.IsFinished(simulation)) {
+		replay.Feed(simulation);
+		simulation.Tick(simulationUpdateInterval);
+		blocksSum += simulation.GetBlockScene()->GetBlocks().size() + simulation.GetBlockScene()->GetDyingBlocksCount();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	PrintResult(simulation, presenter, replay.GetTicksPlayed(simulation), elapsed.count(), blocksSum);
+	return 0;
+}
+
+// threads started per call, indices handed out one at a time
+static void ThreadParallelFor(const int count, const std::function<void(int)>& body) {
+
+	const int workers = std::min(count, static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+
+	std::atomic<int> next {0};
+	const auto work = [&]() {
+		for (int i = next++; i < count; i = next++)
+			body(i);
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < workers; ++i)
+		threads.emplace_back(work);
+
+	work();
+	for (auto& thread : threads)
+		thread.join();
+}
+
+template <typename Board> static int Autoplay(const unsigned long long ticks, const uint64_t seed, const float budgetMs) {
+
+	BenchPresenter presenter;
+	BasicYetrixSimulation<Board> simulation(seed);
+	simulation.SetPresenter(&presenter);
+
+	typename BasicAutoplayer<Board>::Settings settings;
+	settings.budgetMs = budgetMs;
+
+	BasicAutoplayer<Board> autoplayer(settings);
+	autoplayer.SetParallelFor(ThreadParallelFor);
+
+	unsigned long long blocksSum = 0;
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned long long tick = 0; tick < ticks; ++tick) {
+		autoplayer.Drive(simulation);
+		simulation.Tick(simulationUpdateInterval);
+		blocksSum += simulation.GetBlockScene()->GetBlocks().size() + simulation.GetBlockScene()->GetDyingBlocksCount();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	PrintResult(simulation, presenter, ticks, elapsed.count(), blocksSum);
+	std::printf("searches: %u, avg %.3f ms, max %.3f ms, timed out: %u\n", autoplayer.GetSearches(), autoplayer.GetAverageSearchMs(), autoplayer.GetMaxSearchMs(), autoplayer.GetTimeouts());
+	PrintCacheStats("rating cache", autoplayer.GetRatingCacheStats());
+
+	return 0;
+}
+
+// The plain run, stepped on its own thread as fast as the presenter calls are taken here. Input comes from the
+// tick hook, so it lands on the same ticks and the game comes out the same.
+static int Threaded(const unsigned long long ticks, const uint64_t seed) {
+
+	BenchPresenter presenter;
+	YetrixSimulation simulation(seed);
+	RandomStream inputRnd(seed, cosmeticRandomStream + 1);
+
+	SimulationThread::Settings settings;
+	settings.stepSeconds = 0.f;
+	settings.maxTicks = ticks;
+
+	SimulationThread thread(simulation, settings);
+
+	// the hook sees the scene as the previous tick left it
+	const uint64_t startTick = simulation.GetTick();
+	unsigned long long blocksSum = 0;
+
+	thread.SetTickHook([&](YetrixSimulation& sim) {
+		if (sim.GetTick() > startTick)
+			blocksSum += sim.GetBlockScene()->GetBlocks().size() + sim.GetBlockScene()->GetDyingBlocksCount();
+
+		ApplyRandomInput(sim, inputRnd);
+	});
+
+	size_t calls = 0;
+	unsigned long long snapshotsSeen = 0;
+	uint64_t lastSnapshotTick = startTick;
+
+	const auto start = std::chrono::steady_clock::now();
+	thread.Start();
+
+	while (thread.IsRunning()) {
+		calls += thread.DispatchCalls(presenter);
+
+		const auto& snapshot = thread.GetSnapshot();
+		if (snapshot.tick != lastSnapshotTick) {
+			lastSnapshotTick = snapshot.tick;
+			++snapshotsSeen;
+		}
+	}
+
+	thread.Stop();
+	calls += thread.DispatchCalls(presenter);
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	blocksSum += simulation.GetBlockScene()->GetBlocks().size() + simulation.GetBlockScene()->GetDyingBlocksCount();
+
+	PrintResult(simulation, presenter, ticks, elapsed.count(), blocksSum);
+	std::printf("presenter calls: %zu, stalls: %u, snapshots seen: %llu\n", calls, thread.GetPresenterStalls(), snapshotsSeen);
+
+	return 0;
+}
+
+// Drops figures at random rotations and columns straight down and clears full rows right away, without
+// the simulation's animations. Exercises the scene's cell index, row masks and condition tracking.
+template <typename Board> static void MeasureBoard(const char* name, const unsigned figuresCount, const uint64_t seed) {
+
+	// the huge board's cell index doesn't belong on the stack
+	const auto scene = std::make_unique<BasicBlockScene<Board>>();
+	RandomStream rnd(seed, cosmeticRandomStream + 2);
+
+	unsigned lines = 0;
+	unsigned gamesOver = 0;
+	long long conditionSum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned figureInd = 0; figureInd < figuresCount; ++figureInd) {
+
+		const auto figure = scene->CreateRandomFigureAt({Board::spawnX, Board::spawnY}, rnd);
+		if (!figure) {
+			++gamesOver;
+			scene->Clear();
+			continue;
+		}
+
+		for (uint32_t turns = rnd.NextBelow(4); turns > 0; --turns)
+			scene->RotateFigure(figure);
+
+		const int shift = static_cast<int>(rnd.NextBelow(Board::width)) - Board::spawnX;
+		for (int step = 0; step < std::abs(shift); ++step)
+			if (!scene->TryMoveBlock({shift < 0 ? -1 : 1, 0}))
+				break;
+
+		unsigned distance = 0;
+		if (scene->CheckFigureCanMove(figure, {0, -1}, distance))
+			for (const auto blockID : figure->GetBlockIDs()) {
+				const auto block = scene->GetBlock(blockID);
+				scene->SetBlockPosition(block, block->GetPosition() - Vec2D(0, static_cast<int>(distance)));
+			}
+
+		scene->DeconstructFigures();
+
+		const auto fullRows = scene->GetFullRows();
+		if (!fullRows.empty()) {
+
+			for (const int y : fullRows)
+				for (int x = 1; x < Board::rightBorderX; ++x)
+					scene->StartDestroy(scene->GetBlock({x, y}, true));
+
+			for (const auto& [blockID, pos] : scene->GetFallingPositions(fullRows))
+				scene->SetBlockPosition(scene->GetBlock(blockID), pos);
+
+			lines += static_cast<unsigned>(fullRows.size());
+		}
+
+		// dying blocks go for good
+		scene->Tick(destroyActorAfter * 2.f);
+
+		conditionSum += scene->CalculateSceneConditionScore();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::printf("%s %dx%d: %u figures, %.3f s, %.0f ns/figure, lines: %u, games over: %u, avg condition: %.1f\n", name, Board::width, Board::checkHeight,
+		figuresCount, elapsed.count(), elapsed.count() * 1e9 / figuresCount, lines, gamesOver, static_cast<double>(conditionSum) / figuresCount);
+}
+
+int main(int argc, char** argv) {
+
+	if (argc > 2 && std::strcmp(argv[1], "--replay") == 0)
+		return Replay(argv[2]);
+
+	if (argc > 1 && std::strcmp(argv[1], "--autoplay") == 0) {
+		const unsigned long long ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000ull;
+		const uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0ull;
+		const float budgetMs = argc > 4 ? std::strtof(argv[4], nullptr) : Autoplayer::Settings().budgetMs;
+		const char* board = argc > 5 ? argv[5] : "classic";
+
+		if (std::strcmp(board, "wide") == 0)
+			return Autoplay<WideBoard>(ticks, seed, budgetMs);
+		if (std::strcmp(board, "huge") == 0)
+			return Autoplay<HugeBoard>(ticks, seed, budgetMs);
+
+		return Autoplay<ClassicBoard>(ticks, seed, budgetMs);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--thread") == 0) {
+		const unsigned long long ticks = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000000ull;
+		const uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0ull;
+		return Threaded(ticks, seed);
+	}
+
+	if (argc > 1 && std::strcmp(argv[1], "--boards") == 0) {
+		const unsigned figures = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 100000u;
+		const uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0ull;
+
+		MeasureBoard<ClassicBoard>("classic", figures, seed);
+		MeasureBoard<WideBoard>("wide", figures, seed);
+		MeasureBoard<HugeBoard>("huge", figures, seed);
+		return 0;
+	}
+
+	const unsigned long long ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000ull;
+	const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0ull;
+	const char* recordPath = argc > 3 ? argv[3] : nullptr;
+
+	BenchPresenter presenter;
+	YetrixSimulation simulation(seed);
+	simulation.SetPresenter(&presenter);
+
+	InputLog log;
+	if (recordPath) {
+		log.Start(seed, "", simulation.GetTick());
+		simulation.SetInputLog(&log);
+	}
+
+	// past the simulation's own streams
+	RandomStream inputRnd(seed, cosmeticRandomStream + 1);
+
+	unsigned long long blocksSum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned long long tick = 0; tick < ticks; ++tick) {
+
+		ApplyRandomInput(simulation, inputRnd);
+		simulation.Tick(simulationUpdateInterval);
+		blocksSum += simulation.GetBlockScene()->GetBlocks().size() + simulation.GetBlockScene()->GetDyingBlocksCount();
+	}
+
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	PrintResult(simulation, presenter, ticks, elapsed.count(), blocksSum);
+	MeasurePlacements(simulation);
+	CompareSaves(simulation);
+
+	if (recordPath) {
+		log.Finish(simulation.GetTick());
+		const auto bytes = log.Serialize();
+		std::ofstream(recordPath, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+	}
+
+	return 0;
+}